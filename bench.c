@@ -0,0 +1,642 @@
+// Bench dos backends de entrada: roda o mesmo jogo roteirizado em cada backend
+// e mede a latência das teclas, o uso de CPU e as trocas de contexto. Depois mede
+// chamadas de sistema e CPU por quadro de cada backend contra o caminho de pipes.c,
+// e por fim a regularidade dos passos curtos do fim da curva de dificuldade.
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/ptrace.h>
+#include <sys/resource.h>
+#include <sys/select.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "entrada.h"
+#include "jogo.h"
+#include "medidas.h"
+#include "placar.h"
+#include "snapshot.h"
+#include "sorteio.h"
+
+#define TECLAS_PADRAO 2000
+#define INTERVALO_TECLA 2000 // Microssegundos entre duas teclas do roteiro
+#define INTERVALO_PASSO 500  // Microssegundos entre dois passos do jogo
+#define INTERVALO_CONSULTA 100 // Microssegundos entre duas consultas à entrada
+#define SEMENTE 42
+#define RAMOS_PADRAO 1000
+#define PASSOS_RAMO 100     // Passos jogados por cada ramo da ramificação
+#define REPETICOES_SNAPSHOT 100000
+#define QUADROS_PADRAO 200
+#define INTERVALO_QUADRO 1000 // Microssegundos de espera entre dois quadros medidos
+#define TECLA_A_CADA 4        // Quadros entre duas teclas digitadas pelo próprio laço
+#define TAMANHO_STATUS 64
+#define LEGADO "pipes.c"
+#define PARTIDAS_PADRAO 1000000
+#define LOTE_PARTIDAS 65536    // Partidas por registrarPartidas ao encher o placar
+#define PARTIDAS_AVULSAS 100   // Partidas gravadas uma a uma, como no fim de cada jogo
+#define CONSULTAS_PLACAR 10000
+#define MELHORES 10
+#define PASSOS_RITMO 400
+#define INTERVALO_RITMO 5000 // Microssegundos por passo, perto do fim da curva padrão
+
+static Mapa mapa; // Mapa padrão, o mesmo em todas as medições
+
+// Sobe, esquerda, desce, direita: a cobrinha anda em quadrados no meio da tela
+static const char ROTEIRO[] = {CIMA, ESQUERDA, BAIXO, DIREITA};
+
+typedef struct {
+    int fd;
+    int total;
+    atomic_ullong* envio; // Instante em que cada tecla foi escrita
+} Roteiro;
+
+typedef struct {
+    int recebidas;
+    long passos;
+    int jogos;
+    unsigned long long* latencias;
+    struct rusage uso;
+    const char* efetivo; // Backend que de fato rodou (o uring pode cair para o epoll)
+} Resultado;
+
+static void dormir(long microssegundos) {
+    struct timespec ts = {microssegundos / 1000000, (microssegundos % 1000000) * 1000};
+    nanosleep(&ts, NULL);
+}
+
+// Thread que "digita" o roteiro no pipe de origem
+static void* digitarRoteiro(void* arg) {
+    Roteiro* roteiro = (Roteiro*)arg;
+    for (int i = 0; i < roteiro->total; i++) {
+        dormir(INTERVALO_TECLA);
+        char tecla = ROTEIRO[i % sizeof(ROTEIRO)];
+        atomic_store_explicit(&roteiro->envio[i], agora(), memory_order_release);
+        if (write(roteiro->fd, &tecla, sizeof(char)) != 1)
+            break;
+    }
+    return NULL;
+}
+
+static void somarUso(struct rusage* total, const struct rusage* depois, const struct rusage* antes) {
+    total->ru_utime.tv_sec += depois->ru_utime.tv_sec - antes->ru_utime.tv_sec;
+    total->ru_utime.tv_usec += depois->ru_utime.tv_usec - antes->ru_utime.tv_usec;
+    total->ru_stime.tv_sec += depois->ru_stime.tv_sec - antes->ru_stime.tv_sec;
+    total->ru_stime.tv_usec += depois->ru_stime.tv_usec - antes->ru_stime.tv_usec;
+    total->ru_nvcsw += depois->ru_nvcsw - antes->ru_nvcsw;
+    total->ru_nivcsw += depois->ru_nivcsw - antes->ru_nivcsw;
+}
+
+static double milissegundos(const struct timeval* tv) {
+    return tv->tv_sec * 1000.0 + tv->tv_usec / 1000.0;
+}
+
+static int compararLatencias(const void* a, const void* b) {
+    unsigned long long x = *(const unsigned long long*)a;
+    unsigned long long y = *(const unsigned long long*)b;
+    return (x > y) - (x < y);
+}
+
+static double percentil(const unsigned long long* ordenadas, int n, double p) {
+    if (n == 0)
+        return 0.0;
+    int i = (int)(p * (n - 1) + 0.5);
+    return ordenadas[i] / 1000.0;
+}
+
+// Cobrinha em zigue-zague ocupando todo o interior da tela, o pior caso do snapshot
+static void preencherCobrinha(Jogo* jogo) {
+    freeLista(&jogo->cobrinha);
+    memset(jogo->ocupacao, 0, palavrasBitmap(jogo->mapa) * sizeof(uint64_t));
+    for (int y = ALTURA - 2; y >= 1; y--) {
+        for (int i = 1; i < LARGURA - 1; i++) {
+            int x = (y % 2 == 0) ? i : LARGURA - 1 - i;
+            anexarSegmento(jogo, x, y);
+        }
+    }
+}
+
+static void medirSnapshot() {
+    Jogo jogo, restaurado;
+    inicializarJogo(&jogo, &mapa, SEMENTE);
+    preencherCobrinha(&jogo);
+
+    size_t tamanho = tamanhoSnapshot(&jogo);
+    unsigned char* buffer = malloc(tamanho);
+    unsigned long long t0 = agora();
+    for (int i = 0; i < REPETICOES_SNAPSHOT; i++)
+        salvarJogo(&jogo, buffer, tamanho);
+    unsigned long long t1 = agora();
+    for (int i = 0; i < REPETICOES_SNAPSHOT; i++) {
+        restaurarJogo(&restaurado, &mapa, buffer, tamanho);
+        finalizarJogo(&restaurado);
+    }
+    unsigned long long t2 = agora();
+    inicializarJogo(&restaurado, &mapa, SEMENTE);
+    for (int i = 0; i < REPETICOES_SNAPSHOT; i++)
+        restaurarSobreJogo(&restaurado, buffer, tamanho);
+    unsigned long long t3 = agora();
+    finalizarJogo(&restaurado);
+
+    printf("snapshot: %zu bytes para %d segmentos, salvar %.0f ns, restaurar %.0f ns, sobre outra partida %.0f ns\n",
+           tamanho, (ALTURA - 2) * (LARGURA - 2), (double)(t1 - t0) / REPETICOES_SNAPSHOT,
+           (double)(t2 - t1) / REPETICOES_SNAPSHOT, (double)(t3 - t2) / REPETICOES_SNAPSHOT);
+    free(buffer);
+    finalizarJogo(&jogo);
+}
+
+// Cada ramo joga alguns passos com teclas aleatórias próprias e devolve quanto sobreviveu
+static int64_t avaliarAleatorio(Jogo* copia, int ramo, void* contexto) {
+    (void)contexto;
+    uint64_t estado = (uint64_t)ramo * 0x9E3779B97F4A7C15ULL + 1;
+    int64_t passos = 0;
+    while (passos < PASSOS_RAMO) {
+        if (xorshift64(&estado) % 4 == 0)
+            mudarDirecao(copia, ROTEIRO[(estado >> 8) % sizeof(ROTEIRO)]);
+        passos++;
+        if (passoJogo(copia) == PASSO_FIM)
+            break;
+    }
+    return copia->pontos * 1000 + passos;
+}
+
+static int medirRamificacao(int ramos) {
+    Jogo jogo;
+    inicializarJogo(&jogo, &mapa, SEMENTE);
+    int64_t* notas = malloc((size_t)ramos * sizeof(int64_t));
+
+    unsigned long long t0 = agora();
+    int resultado = ramificarJogo(&jogo, ramos, 0, avaliarAleatorio, NULL, notas);
+    double segundos = (agora() - t0) / 1e9;
+
+    int melhor = 0;
+    for (int i = 0; i < ramos; i++)
+        if (notas[i] > notas[melhor])
+            melhor = i;
+    printf("ramificação: %d ramos de até %d passos em %.1f ms (%.0f ramos/s), melhor ramo %d\n",
+           ramos, PASSOS_RAMO, segundos * 1000, ramos / segundos, melhor);
+    free(notas);
+    finalizarJogo(&jogo);
+    return resultado;
+}
+
+// Laço de quadros medido, num filho com stdout em /dev/null: cada quadro consulta a
+// entrada, renderiza, escreve e dorme, como o cobrinha. O próprio laço digita uma tecla
+// a cada TECLA_A_CADA quadros; essas escritas são descontadas da contagem. Sem backend
+// segue o caminho de pipes.c: select e read de uma tecla por quadro, system("clear") e
+// um printf por caractere com stdout em buffer de linha, como num terminal.
+static void rodarQuadros(const char* backend, int quadros) {
+    int fonte[2];
+    int nulo = open("/dev/null", O_WRONLY);
+    if (pipe(fonte) == -1 || nulo == -1)
+        _exit(EXIT_FAILURE);
+    dup2(nulo, STDOUT_FILENO);
+    dup2(nulo, STDERR_FILENO);
+    close(nulo);
+    setvbuf(stdout, NULL, _IOLBF, 0);
+
+    Entrada entrada;
+    if (backend != NULL && criarEntrada(&entrada, backend, fonte[0]) == -1)
+        _exit(EXIT_FAILURE);
+    Jogo jogo;
+    inicializarJogo(&jogo, &mapa, SEMENTE);
+    char* quadro = malloc(tamanhoQuadro(&mapa) + TAMANHO_STATUS);
+
+    for (int i = 0; i < quadros; i++) {
+        char tecla;
+        if (i % TECLA_A_CADA == 0) {
+            tecla = ROTEIRO[(i / TECLA_A_CADA) % sizeof(ROTEIRO)];
+            if (write(fonte[1], &tecla, sizeof(char)) != 1)
+                _exit(EXIT_FAILURE);
+        }
+
+        Relogio relogio = relogioJogo(&jogo);
+        if (backend == NULL) {
+            struct timeval tv = {0, 0};
+            fd_set fds;
+            FD_ZERO(&fds);
+            FD_SET(fonte[0], &fds);
+            if (select(fonte[0] + 1, &fds, NULL, NULL, &tv) > 0 && read(fonte[0], &tecla, sizeof(char)) == 1)
+                mudarDirecao(&jogo, tecla);
+            montarTela(&jogo);
+            if (system("clear") == -1)
+                _exit(EXIT_FAILURE);
+            for (int y = 0; y < mapa.altura; y++) {
+                for (int x = 0; x < mapa.largura; x++)
+                    printf("%c", jogo.tela[y * mapa.largura + x]);
+                printf("\n");
+            }
+            printf("Tempo: %02d:%02d\n", relogio.minutos, relogio.segundos);
+        } else {
+            while (lerEntrada(&entrada, &tecla) == 1)
+                mudarDirecao(&jogo, tecla);
+            size_t n = renderizarTela(&jogo, quadro);
+            n += (size_t)snprintf(quadro + n, TAMANHO_STATUS, "Tempo: %02d:%02d  Pontos: %d\n",
+                                  relogio.minutos, relogio.segundos, jogo.pontos);
+            escreverQuadro(&entrada, STDOUT_FILENO, quadro, n);
+        }
+
+        dormir(INTERVALO_QUADRO);
+        if (passoJogo(&jogo) == PASSO_FIM)
+            reiniciarJogo(&jogo, SEMENTE + i);
+    }
+
+    if (backend != NULL) {
+        descarregarSaida(&entrada);
+        encerrarEntrada(&entrada);
+    }
+    finalizarJogo(&jogo);
+    free(quadro);
+    _exit(EXIT_SUCCESS);
+}
+
+static pid_t lancarQuadros(const char* backend, int quadros, int rastrear) {
+    fflush(stdout);
+    pid_t filho = fork();
+    if (filho == 0) {
+        if (rastrear) {
+            if (ptrace(PTRACE_TRACEME, 0, NULL, NULL) == -1)
+                _exit(SAIDA_SEM_RASTREIO);
+            raise(SIGSTOP);
+        }
+        rodarQuadros(backend, quadros);
+    }
+    return filho;
+}
+
+// Uma rodada seguida por ptrace para contar as chamadas e outra livre para medir a CPU
+// (em microssegundos, com os processos que o laço criou)
+static int medirRodada(const char* backend, int quadros, long* chamadas, double* cpu) {
+    pid_t filho = lancarQuadros(backend, quadros, 1);
+    if (filho < 0)
+        return -1;
+    *chamadas = contarChamadasSistema(filho);
+
+    struct rusage antes, depois, uso;
+    int status;
+    getrusage(RUSAGE_CHILDREN, &antes);
+    filho = lancarQuadros(backend, quadros, 0);
+    if (filho < 0 || waitpid(filho, &status, 0) != filho)
+        return -1;
+    getrusage(RUSAGE_CHILDREN, &depois);
+    memset(&uso, 0, sizeof(uso));
+    somarUso(&uso, &depois, &antes);
+    *cpu = (milissegundos(&uso.ru_utime) + milissegundos(&uso.ru_stime)) * 1000.0;
+    return WIFEXITED(status) && WEXITSTATUS(status) == 0 ? 0 : -1;
+}
+
+// Desconta o custo de abrir e fechar o backend com uma rodada sem quadros
+static int medirQuadros(const char* nome, int quadros) {
+    const char* backend = strcmp(nome, LEGADO) == 0 ? NULL : nome;
+    long chamadas, chamadasVazia;
+    double cpu, cpuVazia;
+    if (medirRodada(backend, quadros, &chamadas, &cpu) == -1 ||
+        medirRodada(backend, 0, &chamadasVazia, &cpuVazia) == -1) {
+        fprintf(stderr, "Erro ao medir os quadros de '%s'.\n", nome);
+        return -1;
+    }
+
+    long teclas = (quadros + TECLA_A_CADA - 1) / TECLA_A_CADA;
+    if (chamadas >= 0 && chamadasVazia >= 0)
+        printf("%-8s %12.2f", nome, (double)(chamadas - chamadasVazia - teclas) / quadros);
+    else
+        printf("%-8s %12s", nome, "n/d");
+    printf(" %12.1f\n", (cpu - cpuVazia) / quadros);
+    return 0;
+}
+
+// Partida sorteada para encher o placar: poucas pontuações altas, muitas baixas
+static Partida sortearPartida(uint64_t* estado) {
+    xorshift64(estado);
+    int pontos = (int)((*estado % 1000) * (*estado % 1000) / 1000);
+    Partida partida = {pontos, (uint32_t)pontos + 3, (uint64_t)(pontos + 10) * DELAY_HORIZONTAL, *estado, mapa.id};
+    return partida;
+}
+
+// Placar com muitas partidas num arquivo temporário: gravação em lotes e avulsa,
+// abertura com o índice pronto e as consultas de top-K e de percentil
+static int medirPlacar(int partidas) {
+    char caminho[] = "/tmp/cobrinha_placarXXXXXX";
+    int fd = mkstemp(caminho);
+    if (fd == -1) {
+        perror("mkstemp");
+        return -1;
+    }
+    close(fd);
+    char indice[sizeof(caminho) + 4];
+    snprintf(indice, sizeof(indice), "%s.idx", caminho);
+
+    Placar placar;
+    Partida* lote = malloc(LOTE_PARTIDAS * sizeof(Partida));
+    uint64_t estado = SEMENTE;
+    int resultado = lote != NULL ? abrirPlacar(&placar, caminho) : -1;
+
+    unsigned long long t0 = agora();
+    for (int feitas = 0; feitas < partidas && resultado == 0; feitas += LOTE_PARTIDAS) {
+        int n = partidas - feitas < LOTE_PARTIDAS ? partidas - feitas : LOTE_PARTIDAS;
+        for (int i = 0; i < n; i++)
+            lote[i] = sortearPartida(&estado);
+        resultado = registrarPartidas(&placar, lote, (size_t)n);
+    }
+    unsigned long long t1 = agora();
+    if (resultado == 0) {
+        fecharPlacar(&placar);
+        resultado = abrirPlacar(&placar, caminho);
+    }
+    unsigned long long t2 = agora();
+    for (int i = 0; i < PARTIDAS_AVULSAS && resultado == 0; i++) {
+        Partida partida = sortearPartida(&estado);
+        resultado = registrarPartida(&placar, &partida);
+    }
+    unsigned long long t3 = agora();
+
+    if (resultado == 0) {
+        // Consultas com o índice e as partidas avulsas ainda fora dele
+        Partida melhores[MELHORES];
+        volatile double acumulado = 0;
+        for (int i = 0; i < CONSULTAS_PLACAR; i++)
+            acumulado += (double)melhoresPartidas(&placar, MELHORES, melhores);
+        unsigned long long t4 = agora();
+        for (int i = 0; i < CONSULTAS_PLACAR; i++)
+            acumulado += percentilPontos(&placar, i % 1000);
+        unsigned long long t5 = agora();
+        for (int i = 0; i < CONSULTAS_PLACAR; i++)
+            acumulado += pontosNoPercentil(&placar, (i % 1000) / 1000.0);
+        unsigned long long t6 = agora();
+
+        printf("placar: %zu partidas, lotes de %d em %.1f ms, abrir com índice %.3f ms, gravar uma %.1f us\n",
+               totalPartidas(&placar), LOTE_PARTIDAS, (t1 - t0) / 1e6, (t2 - t1) / 1e6,
+               (double)(t3 - t2) / PARTIDAS_AVULSAS / 1000.0);
+        printf("placar: top-%d %.2f us, percentil de uma pontuação %.2f us, pontuação num percentil %.2f us"
+               " (mediana %d, p99 %d)\n",
+               MELHORES, (double)(t4 - t3) / CONSULTAS_PLACAR / 1000.0,
+               (double)(t5 - t4) / CONSULTAS_PLACAR / 1000.0, (double)(t6 - t5) / CONSULTAS_PLACAR / 1000.0,
+               pontosNoPercentil(&placar, 0.5), pontosNoPercentil(&placar, 0.99));
+        fecharPlacar(&placar);
+    }
+
+    free(lote);
+    unlink(caminho);
+    unlink(indice);
+    return resultado;
+}
+
+static void desenharQuadro(Jogo* jogo, char* quadro, int fd) {
+    size_t n = renderizarTela(jogo, quadro);
+    if (write(fd, quadro, n) != (ssize_t)n)
+        _exit(EXIT_FAILURE);
+}
+
+// Passos curtos com um quadro desenhado em cada um: o laço antigo, que dorme o
+// intervalo depois de desenhar, contra os prazos absolutos do Ritmo. Mede o quanto
+// cada período fugiu do intervalo e quanto o relógio real se afastou do virtual.
+static int medirRitmo(void) {
+    int nulo = open("/dev/null", O_WRONLY);
+    char especificacao[32];
+    snprintf(especificacao, sizeof(especificacao), "constante:%d", INTERVALO_RITMO);
+    Curva curva;
+    char* quadro = malloc(tamanhoQuadro(&mapa));
+    unsigned long long* desvios = malloc(PASSOS_RITMO * sizeof(unsigned long long));
+    unsigned long long* acordares = malloc(PASSOS_RITMO * sizeof(unsigned long long));
+    if (nulo == -1 || quadro == NULL || desvios == NULL || acordares == NULL || lerCurva(&curva, especificacao) == -1) {
+        fprintf(stderr, "Erro ao preparar a medição do ritmo.\n");
+        free(quadro);
+        free(desvios);
+        free(acordares);
+        if (nulo != -1)
+            close(nulo);
+        return -1;
+    }
+
+    Jogo jogo;
+    inicializarJogo(&jogo, &mapa, SEMENTE);
+    jogo.curva = &curva;
+    printf("\n%d passos de %d us, desenhando em /dev/null\n\n", PASSOS_RITMO, INTERVALO_RITMO);
+    printf("%-8s %13s %13s %13s %13s %11s %8s %8s\n", "modo", "desvio p50", "desvio p99", "desvio max",
+           "acordar p99", "deriva(ms)", "pulados", "perdidos");
+
+    for (int modo = 0; modo < 2; modo++) {
+        reiniciarJogo(&jogo, SEMENTE);
+        Ritmo ritmo;
+        iniciarRitmo(&ritmo);
+        int pulados = 0;
+        unsigned long long inicio = agora(), anterior = inicio;
+
+        // Acordar: quanto depois do pedido o laço voltou a rodar (o fim do sono no
+        // laço antigo, o prazo no Ritmo)
+        for (int i = 0; i < PASSOS_RITMO; i++) {
+            if (modo == 0) {
+                desenharQuadro(&jogo, quadro, nulo);
+                unsigned long long antes = agora(), pedido = atrasoPasso(&jogo) * 1000ULL;
+                dormir(atrasoPasso(&jogo));
+                unsigned long long dormido = agora() - antes;
+                acordares[i] = dormido > pedido ? dormido - pedido : 0;
+            } else {
+                agendarPasso(&ritmo, atrasoPasso(&jogo));
+                if (passoAtrasado(&ritmo))
+                    pulados++;
+                else
+                    desenharQuadro(&jogo, quadro, nulo);
+                acordares[i] = esperarPasso(&ritmo);
+            }
+
+            mudarDirecao(&jogo, ROTEIRO[(i / TECLA_A_CADA) % sizeof(ROTEIRO)]);
+            if (passoJogo(&jogo) == PASSO_FIM)
+                reiniciarJogo(&jogo, SEMENTE + i);
+            unsigned long long instante = agora();
+            unsigned long long periodo = instante - anterior;
+            unsigned long long esperado = INTERVALO_RITMO * 1000ULL;
+            desvios[i] = periodo > esperado ? periodo - esperado : esperado - periodo;
+            anterior = instante;
+        }
+
+        qsort(desvios, PASSOS_RITMO, sizeof(unsigned long long), compararLatencias);
+        qsort(acordares, PASSOS_RITMO, sizeof(unsigned long long), compararLatencias);
+        printf("%-8s %10.1f us %10.1f us %10.1f us %10.1f us %11.2f %8d ", modo == 0 ? "usleep" : "prazo",
+               percentil(desvios, PASSOS_RITMO, 0.50), percentil(desvios, PASSOS_RITMO, 0.99),
+               percentil(desvios, PASSOS_RITMO, 1.0), percentil(acordares, PASSOS_RITMO, 0.99),
+               ((double)(anterior - inicio) - (double)PASSOS_RITMO * INTERVALO_RITMO * 1000.0) / 1e6, pulados);
+        // O laço antigo não tem prazo a perder: cada atraso só empurra os passos seguintes
+        if (modo == 0)
+            printf("%8s\n", "-");
+        else
+            printf("%8llu\n", (unsigned long long)ritmo.perdidos);
+    }
+
+    finalizarJogo(&jogo);
+    free(desvios);
+    free(acordares);
+    free(quadro);
+    close(nulo);
+    return 0;
+}
+
+static int rodarBackend(const char* nome, int total, Resultado* resultado) {
+    int fonte[2];
+    if (pipe(fonte) == -1) {
+        perror("pipe");
+        return -1;
+    }
+
+    struct rusage antesProprio, antesFilhos, depoisProprio, depoisFilhos;
+    getrusage(RUSAGE_SELF, &antesProprio);
+    getrusage(RUSAGE_CHILDREN, &antesFilhos);
+
+    Entrada entrada;
+    if (criarEntrada(&entrada, nome, fonte[0]) == -1) {
+        fprintf(stderr, "Erro ao iniciar o backend '%s'.\n", nome);
+        close(fonte[0]);
+        close(fonte[1]);
+        return -1;
+    }
+
+    Roteiro roteiro = {fonte[1], total, calloc(total, sizeof(atomic_ullong))};
+    memset(resultado, 0, sizeof(*resultado));
+    resultado->efetivo = nomeEntrada(&entrada);
+    resultado->latencias = calloc(total, sizeof(unsigned long long));
+
+    pthread_t digitador;
+    if (pthread_create(&digitador, NULL, digitarRoteiro, &roteiro) != 0) {
+        printf("Erro ao criar thread do roteiro.\n");
+        exit(EXIT_FAILURE);
+    }
+
+    Jogo jogo;
+    char* quadro = malloc(tamanhoQuadro(&mapa));
+    inicializarJogo(&jogo, &mapa, SEMENTE);
+    resultado->jogos = 1;
+
+    unsigned long long prazo = agora() + (unsigned long long)total * INTERVALO_TECLA * 1000ULL + 2000000000ULL;
+    unsigned long long proximoPasso = agora();
+
+    while (resultado->recebidas < total && agora() < prazo) {
+        char tecla;
+        while (resultado->recebidas < total && lerEntrada(&entrada, &tecla) == 1) {
+            unsigned long long envio = atomic_load_explicit(&roteiro.envio[resultado->recebidas], memory_order_acquire);
+            resultado->latencias[resultado->recebidas++] = agora() - envio;
+            mudarDirecao(&jogo, tecla);
+        }
+
+        if (agora() >= proximoPasso) {
+            renderizarTela(&jogo, quadro);
+            resultado->passos++;
+            if (passoJogo(&jogo) == PASSO_FIM) {
+                reiniciarJogo(&jogo, SEMENTE + resultado->jogos++);
+            }
+            proximoPasso += INTERVALO_PASSO * 1000ULL;
+        }
+
+        dormir(INTERVALO_CONSULTA);
+    }
+
+    finalizarJogo(&jogo);
+    free(quadro);
+    pthread_join(digitador, NULL);
+    encerrarEntrada(&entrada);
+    close(fonte[1]);
+    close(fonte[0]);
+    free(roteiro.envio);
+
+    getrusage(RUSAGE_SELF, &depoisProprio);
+    getrusage(RUSAGE_CHILDREN, &depoisFilhos);
+    somarUso(&resultado->uso, &depoisProprio, &antesProprio);
+    somarUso(&resultado->uso, &depoisFilhos, &antesFilhos);
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
+    int total = TECLAS_PADRAO;
+    int ramos = RAMOS_PADRAO;
+    int quadros = QUADROS_PADRAO;
+    int partidas = PARTIDAS_PADRAO;
+    const char* somente = NULL;
+    int opcao;
+
+    while ((opcao = getopt(argc, argv, "n:b:r:q:l:h")) != -1) {
+        switch (opcao) {
+            case 'n':
+                total = atoi(optarg);
+                break;
+            case 'b':
+                somente = optarg;
+                break;
+            case 'r':
+                ramos = atoi(optarg);
+                break;
+            case 'q':
+                quadros = atoi(optarg);
+                break;
+            case 'l':
+                partidas = atoi(optarg);
+                break;
+            default:
+                fprintf(stderr, "Uso: %s [-n teclas] [-b backend] [-r ramos] [-q quadros] [-l partidas]\n", argv[0]);
+                fprintf(stderr, "  -b  também aceita %s, só na medição por quadro\n", LEGADO);
+                return opcao == 'h' ? EXIT_SUCCESS : EXIT_FAILURE;
+        }
+    }
+    if (total <= 0 || ramos <= 0 || quadros <= 0 || partidas <= 0) {
+        fprintf(stderr, "Número de teclas, de ramos, de quadros ou de partidas inválido.\n");
+        return EXIT_FAILURE;
+    }
+
+    if (mapaPadrao(&mapa) == -1)
+        return EXIT_FAILURE;
+
+    printf("%d teclas a cada %d us, passo de %d us, consulta a cada %d us\n\n",
+           total, INTERVALO_TECLA, INTERVALO_PASSO, INTERVALO_CONSULTA);
+    printf("%-8s %9s %9s %9s %9s %9s %9s %9s %8s %6s\n",
+           "backend", "teclas", "p50(us)", "p99(us)", "max(us)", "user(ms)", "sys(ms)", "csw vol", "csw inv", "jogos");
+
+    int falhas = 0;
+    for (int i = 0; i < NUM_ENTRADAS; i++) {
+        if (somente != NULL && strcmp(somente, NOMES_ENTRADAS[i]) != 0)
+            continue;
+
+        Resultado r;
+        if (rodarBackend(NOMES_ENTRADAS[i], total, &r) == -1) {
+            falhas++;
+            continue;
+        }
+
+        qsort(r.latencias, r.recebidas, sizeof(unsigned long long), compararLatencias);
+        printf("%-8s %9d %9.1f %9.1f %9.1f %9.1f %9.1f %9ld %8ld %6d\n",
+               NOMES_ENTRADAS[i], r.recebidas,
+               percentil(r.latencias, r.recebidas, 0.50),
+               percentil(r.latencias, r.recebidas, 0.99),
+               percentil(r.latencias, r.recebidas, 1.0),
+               milissegundos(&r.uso.ru_utime), milissegundos(&r.uso.ru_stime),
+               r.uso.ru_nvcsw, r.uso.ru_nivcsw, r.jogos);
+        if (strcmp(r.efetivo, NOMES_ENTRADAS[i]) != 0)
+            printf("%-8s indisponível aqui, medido como %s\n", NOMES_ENTRADAS[i], r.efetivo);
+        if (r.recebidas < total)
+            falhas++;
+        free(r.latencias);
+    }
+
+    printf("\n%d quadros a cada %d us com stdout em /dev/null (chamadas e CPU incluem os processos criados)\n\n",
+           quadros, INTERVALO_QUADRO);
+    printf("%-8s %12s %12s\n", "modo", "chamadas/q", "cpu(us)/q");
+    for (int i = -1; i < NUM_ENTRADAS; i++) {
+        const char* nome = i == -1 ? LEGADO : NOMES_ENTRADAS[i];
+        if (somente != NULL && strcmp(somente, nome) != 0)
+            continue;
+        if (medirQuadros(nome, quadros) == -1)
+            falhas++;
+    }
+
+    printf("\n");
+    medirSnapshot();
+    if (medirRamificacao(ramos) == -1)
+        falhas++;
+    if (medirPlacar(partidas) == -1)
+        falhas++;
+    if (medirRitmo() == -1)
+        falhas++;
+
+    liberarMapa(&mapa);
+    return falhas == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,55 @@
+#ifndef BINARIO_H
+#define BINARIO_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Inteiros little-endian e FNV-1a de 32 bits dos formatos em disco (snapshot,
+// placar) e da impressão digital dos mapas. Cabeçalho interno da biblioteca.
+
+#define FNV1A_INICIAL 2166136261u
+
+static inline void escrever16(unsigned char* p, uint16_t v) {
+    p[0] = (unsigned char)v;
+    p[1] = (unsigned char)(v >> 8);
+}
+
+static inline void escrever32(unsigned char* p, uint32_t v) {
+    for (int i = 0; i < 4; i++)
+        p[i] = (unsigned char)(v >> (8 * i));
+}
+
+static inline void escrever64(unsigned char* p, uint64_t v) {
+    for (int i = 0; i < 8; i++)
+        p[i] = (unsigned char)(v >> (8 * i));
+}
+
+static inline uint16_t ler16(const unsigned char* p) {
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static inline uint32_t ler32(const unsigned char* p) {
+    uint32_t v = 0;
+    for (int i = 3; i >= 0; i--)
+        v = (v << 8) | p[i];
+    return v;
+}
+
+static inline uint64_t ler64(const unsigned char* p) {
+    uint64_t v = 0;
+    for (int i = 7; i >= 0; i--)
+        v = (v << 8) | p[i];
+    return v;
+}
+
+// Continua o hash h sobre mais n bytes; comece com FNV1A_INICIAL
+static inline uint32_t fnv1a(uint32_t h, const void* dados, size_t n) {
+    const unsigned char* p = (const unsigned char*)dados;
+    for (size_t i = 0; i < n; i++) {
+        h ^= p[i];
+        h *= 16777619u;
+    }
+    return h;
+}
+
+#endif
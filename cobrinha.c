@@ -0,0 +1,241 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "entrada.h"
+#include "jogo.h"
+#include "placar.h"
+#include "snapshot.h"
+
+#define GRAVAR 'g' // Tecla que grava um snapshot da partida
+#define SNAPSHOT_PADRAO "cobrinha.snap"
+#define TAMANHO_STATUS 64 // Linha do relógio e dos pontos no fim do quadro
+#define PLACAR_PADRAO "cobrinha.placar"
+#define MELHORES 5 // Partidas mostradas no placar
+
+static struct termios terminalOriginal;
+
+void configurarTerminalPadrao() {
+    tcsetattr(STDIN_FILENO, TCSANOW, &terminalOriginal);
+}
+
+void configurarTerminal() {
+    struct termios t;
+    tcgetattr(STDIN_FILENO, &terminalOriginal);
+    t = terminalOriginal;
+    t.c_lflag &= ~(ICANON | ECHO);
+    tcsetattr(STDIN_FILENO, TCSANOW, &t);
+}
+
+static void uso(const char* programa) {
+    fprintf(stderr, "Uso: %s [-b backend] [-s semente] [-m mapa] [-f snapshot] [-c] [-p placar] [-t] [-v curva]\n", programa);
+    fprintf(stderr, "  -m  arquivo de mapa (padrão: %dx%d com parede na borda)\n", LARGURA, ALTURA);
+    fprintf(stderr, "  -f  arquivo gravado com a tecla '%c' (padrão %s)\n", GRAVAR, SNAPSHOT_PADRAO);
+    fprintf(stderr, "  -c  continua a partida gravada no arquivo\n");
+    fprintf(stderr, "  -p  arquivo do placar (padrão %s)\n", PLACAR_PADRAO);
+    fprintf(stderr, "  -t  mostra o placar e sai\n");
+    fprintf(stderr, "  -v  intervalo por pontuação em microssegundos (padrão %s):\n", CURVA_PADRAO);
+    fprintf(stderr, "      constante:inicial, linear:inicial:minimo:passo ou exp:inicial:minimo:fator\n");
+    fprintf(stderr, "Backends:");
+    for (int i = 0; i < NUM_ENTRADAS; i++)
+        fprintf(stderr, " %s", NOMES_ENTRADAS[i]);
+    fprintf(stderr, "\n");
+}
+
+static void mostrarPlacar(const Placar* placar) {
+    Partida melhores[MELHORES];
+    size_t n = melhoresPartidas(placar, MELHORES, melhores);
+    printf("Placar (%zu partidas):\n", totalPartidas(placar));
+    for (size_t i = 0; i < n; i++) {
+        uint64_t segundos = melhores[i].duracao / 1000000;
+        printf("%2zu. %5d pontos  %4u segmentos  %02d:%02d  replay %llu\n", i + 1, melhores[i].pontos,
+               melhores[i].comprimento, (int)(segundos / 60), (int)(segundos % 60),
+               (unsigned long long)melhores[i].replay);
+    }
+}
+
+// Grava a partida que acabou e mostra como ela ficou entre as outras
+static void registrarNoPlacar(Placar* placar, const Jogo* jogo, uint64_t replay) {
+    Partida partida = {jogo->pontos, (uint32_t)comprimentoCobrinha(jogo), jogo->decorrido, replay, jogo->mapa->id};
+    if (registrarPartida(placar, &partida) == -1) {
+        fprintf(stderr, "Erro ao gravar a partida no placar.\n");
+        return;
+    }
+    printf("Melhor que %.1f%% das partidas\n", percentilPontos(placar, jogo->pontos) * 100.0);
+    mostrarPlacar(placar);
+}
+
+// Espera o jogador responder 1 ou 0; o fim da entrada conta como não
+static int perguntarJogarNovamente(Entrada* entrada) {
+    char tecla;
+    int lido;
+    printf("Deseja jogar novamente? (1 para Sim, 0 para Não): ");
+    fflush(stdout);
+    while ((lido = lerEntrada(entrada, &tecla)) != -1) {
+        if (lido == 1 && (tecla == '1' || tecla == '0'))
+            return tecla == '1';
+        usleep(10000);
+    }
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
+    const char* backend = "pipe";
+    uint64_t semente = (uint64_t)time(NULL);
+    const char* arquivoSnapshot = SNAPSHOT_PADRAO;
+    const char* arquivoMapa = NULL;
+    const char* arquivoPlacar = PLACAR_PADRAO;
+    const char* especificacaoCurva = CURVA_PADRAO;
+    int continuar = 0;
+    int soPlacar = 0;
+    int opcao;
+
+    while ((opcao = getopt(argc, argv, "b:s:m:f:cp:tv:h")) != -1) {
+        switch (opcao) {
+            case 'b':
+                backend = optarg;
+                break;
+            case 's':
+                semente = strtoull(optarg, NULL, 10);
+                break;
+            case 'm':
+                arquivoMapa = optarg;
+                break;
+            case 'f':
+                arquivoSnapshot = optarg;
+                break;
+            case 'c':
+                continuar = 1;
+                break;
+            case 'p':
+                arquivoPlacar = optarg;
+                break;
+            case 't':
+                soPlacar = 1;
+                break;
+            case 'v':
+                especificacaoCurva = optarg;
+                break;
+            default:
+                uso(argv[0]);
+                return opcao == 'h' ? EXIT_SUCCESS : EXIT_FAILURE;
+        }
+    }
+
+    // Sem placar o jogo continua, só não guarda as partidas
+    Placar placar;
+    int temPlacar = abrirPlacar(&placar, arquivoPlacar) == 0;
+    if (soPlacar) {
+        if (temPlacar) {
+            mostrarPlacar(&placar);
+            fecharPlacar(&placar);
+        }
+        return temPlacar ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    Curva curva;
+    if (lerCurva(&curva, especificacaoCurva) == -1) {
+        if (temPlacar)
+            fecharPlacar(&placar);
+        return EXIT_FAILURE;
+    }
+
+    Mapa mapa;
+    if ((arquivoMapa != NULL ? carregarMapa(&mapa, arquivoMapa) : mapaPadrao(&mapa)) == -1)
+        return EXIT_FAILURE;
+
+    Jogo jogo;
+    if (continuar && lerSnapshot(&jogo, &mapa, arquivoSnapshot) == -1) {
+        fprintf(stderr, "Erro ao ler o snapshot '%s' (corrompido ou de outro mapa).\n", arquivoSnapshot);
+        liberarMapa(&mapa);
+        return EXIT_FAILURE;
+    }
+
+    configurarTerminal();
+
+    Entrada entrada;
+    if (criarEntrada(&entrada, backend, STDIN_FILENO) == -1) {
+        configurarTerminalPadrao();
+        fprintf(stderr, "Erro ao iniciar o backend de entrada '%s'.\n", backend);
+        uso(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    char* quadro = malloc(tamanhoQuadro(&mapa) + TAMANHO_STATUS);
+    if (quadro == NULL) {
+        printf("Erro: Não foi possível alocar memória para o quadro.\n");
+        exit(EXIT_FAILURE);
+    }
+    int jogarNovamente = 1;
+    // Partida vinda de snapshot fica com o estado do sorteio no momento da gravação
+    uint64_t replay = continuar ? jogo.semente : semente;
+
+    while (jogarNovamente) {
+        if (continuar) {
+            continuar = 0; // Só a primeira partida vem do snapshot
+        } else {
+            replay = semente;
+            inicializarJogo(&jogo, &mapa, semente++);
+        }
+        jogo.curva = &curva;
+
+        Ritmo ritmo;
+        iniciarRitmo(&ritmo);
+        uint64_t maiorAtraso = 0; // Pior atraso ao acordar para um passo, em nanossegundos
+        while (1) {
+            // O prazo conta do passo anterior, não do fim do desenho: o intervalo da
+            // curva vale mesmo quando ele é de poucos milissegundos
+            agendarPasso(&ritmo, atrasoPasso(&jogo));
+
+            // Quadro que não cabe antes do prazo é pulado; o próximo já mostra o estado novo
+            if (!passoAtrasado(&ritmo)) {
+                // Imprime a tela com todos os objetos nela e o relógio numa escrita só,
+                // que no backend uring é submetida ao anel sem esperar
+                size_t n = renderizarTela(&jogo, quadro);
+                Relogio relogio = relogioJogo(&jogo);
+                n += (size_t)snprintf(quadro + n, TAMANHO_STATUS, "Tempo: %02d:%02d  Pontos: %d\n",
+                                      relogio.minutos, relogio.segundos, jogo.pontos);
+                escreverQuadro(&entrada, STDOUT_FILENO, quadro, n);
+            }
+
+            uint64_t atraso = esperarPasso(&ritmo);
+            if (atraso > maiorAtraso)
+                maiorAtraso = atraso;
+
+            char tecla;
+            while (lerEntrada(&entrada, &tecla) == 1) {
+                if (tecla == GRAVAR && gravarSnapshot(&jogo, arquivoSnapshot) == -1)
+                    fprintf(stderr, "Erro ao gravar o snapshot '%s'.\n", arquivoSnapshot);
+                mudarDirecao(&jogo, tecla);
+            }
+
+            if (passoJogo(&jogo) == PASSO_FIM) {
+                descarregarSaida(&entrada);
+                printf("Game Over! Score: %d\n", jogo.pontos);
+                printf("Ritmo: %llu passos fora do prazo, maior atraso ao acordar %.1f ms\n",
+                       (unsigned long long)ritmo.perdidos, maiorAtraso / 1e6);
+                if (temPlacar)
+                    registrarNoPlacar(&placar, &jogo, replay);
+                fflush(stdout);
+                break;
+            }
+        }
+
+        finalizarJogo(&jogo);
+        jogarNovamente = perguntarJogarNovamente(&entrada);
+        printf("\n");
+        fflush(stdout);
+    }
+
+    encerrarEntrada(&entrada);
+    free(quadro);
+    liberarMapa(&mapa);
+    if (temPlacar)
+        fecharPlacar(&placar);
+    configurarTerminalPadrao(); // Restaura as configurações do terminal para o modo padrão
+
+    return 0;
+}
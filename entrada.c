@@ -0,0 +1,631 @@
+#include "entrada.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <poll.h>
+#include <signal.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <sys/mman.h>
+#include <sys/select.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#ifdef TEM_IO_URING
+#include <linux/io_uring.h>
+#include <sys/syscall.h>
+#endif
+
+#define ESPERA_PRODUTOR 20 // Milissegundos entre duas checagens do pedido de parada
+
+// ---------------------------------------------------------------------------
+// Fila SPSC: o produtor só escreve a cauda e o consumidor só escreve a cabeça
+
+static void empurrarFila(FilaSPSC* fila, char tecla) {
+    unsigned long cauda = atomic_load_explicit(&fila->cauda, memory_order_relaxed);
+    // Fila cheia: espera o consumidor em vez de descartar teclas
+    while (cauda - atomic_load_explicit(&fila->cabeca, memory_order_acquire) == TAMANHO_FILA) {
+        if (atomic_load_explicit(&fila->parar, memory_order_acquire))
+            return;
+        usleep(100);
+    }
+    fila->teclas[cauda % TAMANHO_FILA] = tecla;
+    atomic_store_explicit(&fila->cauda, cauda + 1, memory_order_release);
+}
+
+static int retirarFila(FilaSPSC* fila, char* tecla) {
+    unsigned long cabeca = atomic_load_explicit(&fila->cabeca, memory_order_relaxed);
+    if (cabeca == atomic_load_explicit(&fila->cauda, memory_order_acquire))
+        return atomic_load_explicit(&fila->fim, memory_order_acquire) ? -1 : 0;
+    *tecla = fila->teclas[cabeca % TAMANHO_FILA];
+    atomic_store_explicit(&fila->cabeca, cabeca + 1, memory_order_release);
+    return 1;
+}
+
+// Laço do produtor: espera o descritor e repassa cada tecla para a fila. O poll com
+// prazo deixa o produtor ver o pedido de parada sem precisar de pthread_cancel.
+static void produzirFila(int fd, FilaSPSC* fila) {
+    struct pollfd pfd = {.fd = fd, .events = POLLIN};
+    char tecla;
+    while (!atomic_load_explicit(&fila->parar, memory_order_acquire)) {
+        int pronto = poll(&pfd, 1, ESPERA_PRODUTOR);
+        if (pronto == 0 || (pronto < 0 && errno == EINTR))
+            continue;
+        if (pronto < 0 || read(fd, &tecla, sizeof(char)) != 1)
+            break;
+        empurrarFila(fila, tecla);
+    }
+    atomic_store_explicit(&fila->fim, 1, memory_order_release);
+}
+
+// Termina o processo leitor dos backends com fork
+static void encerrarFilho(Entrada* entrada) {
+    if (entrada->filho > 0) {
+        kill(entrada->filho, SIGTERM);
+        waitpid(entrada->filho, NULL, 0);
+        entrada->filho = -1;
+    }
+}
+
+// Lê uma tecla de um descritor não bloqueante
+static int lerDescritor(int fd, char* tecla) {
+    ssize_t n = read(fd, tecla, sizeof(char));
+    if (n == 1)
+        return 1;
+    if (n < 0 && (errno == EAGAIN || errno == EINTR))
+        return 0;
+    return -1;
+}
+
+// Saída dos backends que não têm escrita própria: write até o quadro sair inteiro
+static int escreverDireto(Entrada* entrada, int fd, const char* dados, size_t tamanho) {
+    (void)entrada;
+    while (tamanho > 0) {
+        ssize_t n = write(fd, dados, tamanho);
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n <= 0)
+            return -1;
+        dados += n;
+        tamanho -= (size_t)n;
+    }
+    return 0;
+}
+
+static void descarregarNada(Entrada* entrada) {
+    (void)entrada;
+}
+
+// ---------------------------------------------------------------------------
+// inline: select com tempo zero direto no descritor, como o kbhit de pipes.c
+
+static int iniciarInline(Entrada* entrada) {
+    (void)entrada;
+    return 0;
+}
+
+static int lerInline(Entrada* entrada, char* tecla) {
+    struct timeval tv = {0, 0};
+    fd_set fds;
+    FD_ZERO(&fds);
+    FD_SET(entrada->fd, &fds);
+    if (select(entrada->fd + 1, &fds, NULL, NULL, &tv) != 1)
+        return 0;
+    return read(entrada->fd, tecla, sizeof(char)) == 1 ? 1 : -1;
+}
+
+static void encerrarNada(Entrada* entrada) {
+    (void)entrada;
+}
+
+// ---------------------------------------------------------------------------
+// pipe: um processo filho lê as teclas e as escreve num pipe
+
+static int iniciarPipe(Entrada* entrada) {
+    int pipefd[2];
+    if (pipe(pipefd) == -1) {
+        perror("pipe");
+        return -1;
+    }
+
+    entrada->filho = fork();
+    if (entrada->filho < 0) {
+        perror("fork");
+        close(pipefd[0]);
+        close(pipefd[1]);
+        return -1;
+    } else if (entrada->filho == 0) { // Processo filho
+        close(pipefd[0]); // Fecha a extremidade de leitura do pipe no processo filho
+        char tecla;
+        while (read(entrada->fd, &tecla, sizeof(char)) == 1) {
+            if (write(pipefd[1], &tecla, sizeof(char)) != 1)
+                break;
+        }
+        _exit(EXIT_SUCCESS);
+    }
+
+    close(pipefd[1]); // Fecha a extremidade de escrita do pipe no processo pai
+    fcntl(pipefd[0], F_SETFL, fcntl(pipefd[0], F_GETFL, 0) | O_NONBLOCK);
+    entrada->aux = pipefd[0];
+    return 0;
+}
+
+static int lerPipe(Entrada* entrada, char* tecla) {
+    return lerDescritor(entrada->aux, tecla);
+}
+
+static void encerrarPipe(Entrada* entrada) {
+    encerrarFilho(entrada);
+    close(entrada->aux);
+}
+
+// ---------------------------------------------------------------------------
+// thread: thread leitora e fila SPSC na memória do próprio processo
+
+static void* threadLeitora(void* arg) {
+    Entrada* entrada = (Entrada*)arg;
+    produzirFila(entrada->fd, entrada->fila);
+    return NULL;
+}
+
+static int iniciarThread(Entrada* entrada) {
+    entrada->fila = calloc(1, sizeof(FilaSPSC));
+    entrada->dados = malloc(sizeof(pthread_t));
+    if (entrada->fila == NULL || entrada->dados == NULL) {
+        free(entrada->fila);
+        free(entrada->dados);
+        return -1;
+    }
+    if (pthread_create((pthread_t*)entrada->dados, NULL, threadLeitora, entrada) != 0) {
+        printf("Erro ao criar thread de entrada.\n");
+        free(entrada->fila);
+        free(entrada->dados);
+        return -1;
+    }
+    return 0;
+}
+
+static int lerFila(Entrada* entrada, char* tecla) {
+    return retirarFila(entrada->fila, tecla);
+}
+
+static void encerrarThread(Entrada* entrada) {
+    atomic_store_explicit(&entrada->fila->parar, 1, memory_order_release);
+    pthread_join(*(pthread_t*)entrada->dados, NULL);
+    free(entrada->dados);
+    free(entrada->fila);
+}
+
+// ---------------------------------------------------------------------------
+// memoria: processo filho e fila SPSC numa página compartilhada via mmap
+
+static int iniciarMemoria(Entrada* entrada) {
+    entrada->fila = mmap(NULL, sizeof(FilaSPSC), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (entrada->fila == MAP_FAILED) {
+        perror("mmap");
+        return -1;
+    }
+
+    entrada->filho = fork();
+    if (entrada->filho < 0) {
+        perror("fork");
+        munmap(entrada->fila, sizeof(FilaSPSC));
+        return -1;
+    } else if (entrada->filho == 0) { // Processo filho
+        produzirFila(entrada->fd, entrada->fila);
+        _exit(EXIT_SUCCESS);
+    }
+    return 0;
+}
+
+static void encerrarMemoria(Entrada* entrada) {
+    atomic_store_explicit(&entrada->fila->parar, 1, memory_order_release);
+    encerrarFilho(entrada);
+    munmap(entrada->fila, sizeof(FilaSPSC));
+}
+
+// ---------------------------------------------------------------------------
+// epoll: o descritor fica registrado e cada consulta é um epoll_wait sem espera
+
+static int iniciarEpoll(Entrada* entrada) {
+    entrada->aux = epoll_create1(EPOLL_CLOEXEC);
+    if (entrada->aux == -1) {
+        perror("epoll_create1");
+        return -1;
+    }
+    struct epoll_event ev = {.events = EPOLLIN, .data.fd = entrada->fd};
+    if (epoll_ctl(entrada->aux, EPOLL_CTL_ADD, entrada->fd, &ev) == -1) {
+        perror("epoll_ctl");
+        close(entrada->aux);
+        return -1;
+    }
+    return 0;
+}
+
+static int lerEpoll(Entrada* entrada, char* tecla) {
+    struct epoll_event ev;
+    if (epoll_wait(entrada->aux, &ev, 1, 0) != 1)
+        return 0;
+    if (ev.events & EPOLLIN)
+        return read(entrada->fd, tecla, sizeof(char)) == 1 ? 1 : -1;
+    return -1; // EPOLLHUP/EPOLLERR sem dados
+}
+
+static void encerrarEpoll(Entrada* entrada) {
+    close(entrada->aux);
+}
+
+// ---------------------------------------------------------------------------
+// uring: a leitura das teclas e a escrita do quadro são operações num io_uring.
+// As filas de submissão e de conclusão ficam em memória compartilhada com o kernel:
+// colher conclusões não custa chamada de sistema e um único io_uring_enter submete
+// tudo o que acumulou (o quadro e a leitura seguinte vão juntos).
+
+#ifdef TEM_IO_URING
+
+#define ENTRADAS_ANEL 8
+#define TAMANHO_LEITURA 64
+
+enum { OP_LEITURA = 1, OP_ESCRITA, OP_CANCELAR };
+
+typedef struct {
+    unsigned char* sq;  // Anel de submissão mapeado
+    size_t tamanhoSq;
+    unsigned char* cq;  // Anel de conclusão (o mesmo mapeamento com IORING_FEAT_SINGLE_MMAP)
+    size_t tamanhoCq;
+    struct io_uring_sqe* sqes;
+    size_t tamanhoSqes;
+    atomic_uint* sqCauda;
+    unsigned* sqIndices;
+    unsigned sqMascara;
+    atomic_uint* cqCabeca;
+    atomic_uint* cqCauda;
+    struct io_uring_cqe* cqes;
+    unsigned cqMascara;
+    unsigned naoSubmetidas;
+
+    // Leitura: no máximo uma em andamento, teclas guardadas até o laço pedir
+    int lendo;
+    int fim;
+    int cancelando; // Cancelamento da leitura pedido e ainda sem resposta
+    int inicio, lidas;
+    char teclas[TAMANHO_LEITURA];
+
+    // Escrita: o quadro no anel e o mais recente que chegou enquanto ele não saía
+    int escrevendo;
+    int saida;
+    char* quadro;
+    size_t tamanhoQuadro, enviados, capacidadeQuadro;
+    char* proximo;
+    size_t tamanhoProximo, capacidadeProximo;
+    int temProximo;
+} Anel;
+
+static int entrarAnel(int fd, unsigned submeter, unsigned minimo, unsigned flags) {
+    return (int)syscall(__NR_io_uring_enter, fd, submeter, minimo, flags, NULL, 0);
+}
+
+// Coloca uma operação no anel de submissão; ela só vai para o kernel em submeterAnel
+static void enfileirarOperacao(Anel* anel, int opcode, int fd, const void* endereco, unsigned tamanho, uint64_t dado) {
+    unsigned cauda = atomic_load_explicit(anel->sqCauda, memory_order_relaxed);
+    // Nunca há mais de três operações vivas, então o anel de oito entradas não enche
+    unsigned i = cauda & anel->sqMascara;
+    struct io_uring_sqe* sqe = &anel->sqes[i];
+    memset(sqe, 0, sizeof(*sqe));
+    sqe->opcode = (unsigned char)opcode;
+    sqe->fd = fd;
+    // Leitura e escrita na posição atual do descritor (pipes e terminais não têm outra);
+    // o cancelamento exige off zerado
+    sqe->off = opcode == IORING_OP_ASYNC_CANCEL ? 0 : (uint64_t)-1;
+    sqe->addr = (uint64_t)(uintptr_t)endereco;
+    sqe->len = tamanho;
+    sqe->user_data = dado;
+    anel->sqIndices[i] = i;
+    atomic_store_explicit(anel->sqCauda, cauda + 1, memory_order_release);
+    anel->naoSubmetidas++;
+}
+
+static int submeterAnel(Entrada* entrada, Anel* anel, unsigned minimo) {
+    while (anel->naoSubmetidas > 0 || minimo > 0) {
+        int n = entrarAnel(entrada->aux, anel->naoSubmetidas, minimo, minimo > 0 ? IORING_ENTER_GETEVENTS : 0);
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n < 0)
+            return -1;
+        anel->naoSubmetidas -= (unsigned)n;
+        minimo = 0;
+    }
+    return 0;
+}
+
+static void armarLeitura(Entrada* entrada, Anel* anel) {
+    if (anel->lendo || anel->fim || anel->inicio < anel->lidas)
+        return;
+    enfileirarOperacao(anel, IORING_OP_READ, entrada->fd, anel->teclas, TAMANHO_LEITURA, OP_LEITURA);
+    anel->lendo = 1;
+}
+
+static void enviarQuadro(Anel* anel) {
+    enfileirarOperacao(anel, IORING_OP_WRITE, anel->saida, anel->quadro + anel->enviados,
+                       (unsigned)(anel->tamanhoQuadro - anel->enviados), OP_ESCRITA);
+    anel->escrevendo = 1;
+}
+
+// Guarda uma cópia do quadro: o chamador reaproveita o buffer antes da escrita terminar
+static void copiarQuadro(char** destino, size_t* capacidade, const char* dados, size_t tamanho) {
+    if (*capacidade < tamanho) {
+        char* novo = realloc(*destino, tamanho);
+        if (novo == NULL) {
+            printf("Erro: Não foi possível alocar memória para o quadro.\n");
+            exit(EXIT_FAILURE);
+        }
+        *destino = novo;
+        *capacidade = tamanho;
+    }
+    memcpy(*destino, dados, tamanho);
+}
+
+static void concluirEscrita(Anel* anel, int resultado) {
+    anel->escrevendo = 0;
+    if (resultado > 0)
+        anel->enviados += (size_t)resultado;
+    else if (resultado != -EAGAIN && resultado != -EINTR)
+        anel->enviados = anel->tamanhoQuadro; // Erro de escrita: o quadro é descartado
+    // Um quadro pela metade termina antes do próximo, senão a tela embaralha
+    if (anel->enviados < anel->tamanhoQuadro) {
+        enviarQuadro(anel);
+    } else if (anel->temProximo) {
+        char* quadro = anel->quadro;
+        size_t capacidade = anel->capacidadeQuadro;
+        anel->quadro = anel->proximo;
+        anel->capacidadeQuadro = anel->capacidadeProximo;
+        anel->tamanhoQuadro = anel->tamanhoProximo;
+        anel->proximo = quadro;
+        anel->capacidadeProximo = capacidade;
+        anel->enviados = 0;
+        anel->temProximo = 0;
+        enviarQuadro(anel);
+    }
+}
+
+// Trata as conclusões que o kernel já publicou, sem chamada de sistema
+static void colherAnel(Anel* anel) {
+    unsigned cabeca = atomic_load_explicit(anel->cqCabeca, memory_order_relaxed);
+    unsigned cauda = atomic_load_explicit(anel->cqCauda, memory_order_acquire);
+    while (cabeca != cauda) {
+        struct io_uring_cqe* cqe = &anel->cqes[cabeca & anel->cqMascara];
+        int resultado = cqe->res;
+        if (cqe->user_data == OP_LEITURA) {
+            anel->lendo = 0;
+            if (resultado > 0) {
+                anel->inicio = 0;
+                anel->lidas = resultado;
+            } else if (resultado != -EAGAIN && resultado != -EINTR) {
+                anel->fim = 1; // Fim da entrada, erro ou leitura cancelada
+            }
+        } else if (cqe->user_data == OP_ESCRITA) {
+            concluirEscrita(anel, resultado);
+        } else if (cqe->user_data == OP_CANCELAR) {
+            // Com 0, -ENOENT (a leitura já terminou) ou -EALREADY a conclusão da leitura
+            // vem de qualquer jeito; outro erro quer dizer que ela pode nunca vir
+            if (resultado != 0 && resultado != -ENOENT && resultado != -EALREADY)
+                anel->cancelando = -1;
+        }
+        cabeca++;
+    }
+    atomic_store_explicit(anel->cqCabeca, cabeca, memory_order_release);
+}
+
+static void liberarAnel(Entrada* entrada, Anel* anel) {
+    if (anel->sqes != NULL && anel->sqes != MAP_FAILED)
+        munmap(anel->sqes, anel->tamanhoSqes);
+    if (anel->cq != NULL && anel->cq != MAP_FAILED && anel->cq != anel->sq)
+        munmap(anel->cq, anel->tamanhoCq);
+    if (anel->sq != NULL && anel->sq != MAP_FAILED)
+        munmap(anel->sq, anel->tamanhoSq);
+    if (entrada->aux != -1)
+        close(entrada->aux);
+    entrada->aux = -1;
+    free(anel->quadro);
+    free(anel->proximo);
+}
+
+// Confere se o kernel conhece as operações usadas (leitura e escrita simples são do 5.6)
+static int operacoesSuportadas(int fd) {
+    size_t tamanho = sizeof(struct io_uring_probe) + 256 * sizeof(struct io_uring_probe_op);
+    struct io_uring_probe* sonda = calloc(1, tamanho);
+    if (sonda == NULL)
+        return 0;
+    int suportadas = syscall(__NR_io_uring_register, fd, IORING_REGISTER_PROBE, sonda, 256) == 0;
+    static const int usadas[] = {IORING_OP_READ, IORING_OP_WRITE, IORING_OP_ASYNC_CANCEL};
+    for (size_t i = 0; suportadas && i < sizeof(usadas) / sizeof(usadas[0]); i++)
+        suportadas = usadas[i] <= sonda->last_op && (sonda->ops[usadas[i]].flags & IO_URING_OP_SUPPORTED);
+    free(sonda);
+    return suportadas;
+}
+
+static int iniciarUring(Entrada* entrada) {
+    struct io_uring_params p;
+    memset(&p, 0, sizeof(p));
+    entrada->aux = (int)syscall(__NR_io_uring_setup, ENTRADAS_ANEL, &p);
+    if (entrada->aux < 0) {
+        entrada->aux = -1; // ENOSYS, ou EPERM com io_uring desligado no sistema
+        return -1;
+    }
+
+    Anel* anel = calloc(1, sizeof(Anel));
+    if (anel == NULL || !operacoesSuportadas(entrada->aux)) {
+        close(entrada->aux);
+        entrada->aux = -1;
+        free(anel);
+        return -1;
+    }
+    anel->tamanhoSq = p.sq_off.array + p.sq_entries * sizeof(unsigned);
+    anel->tamanhoCq = p.cq_off.cqes + p.cq_entries * sizeof(struct io_uring_cqe);
+    int unico = (p.features & IORING_FEAT_SINGLE_MMAP) != 0;
+    if (unico && anel->tamanhoCq > anel->tamanhoSq)
+        anel->tamanhoSq = anel->tamanhoCq;
+    anel->sq = mmap(NULL, anel->tamanhoSq, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, entrada->aux, IORING_OFF_SQ_RING);
+    anel->cq = unico ? anel->sq
+                     : mmap(NULL, anel->tamanhoCq, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, entrada->aux, IORING_OFF_CQ_RING);
+    anel->tamanhoSqes = p.sq_entries * sizeof(struct io_uring_sqe);
+    anel->sqes = mmap(NULL, anel->tamanhoSqes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, entrada->aux, IORING_OFF_SQES);
+    if (anel->sq == MAP_FAILED || anel->cq == MAP_FAILED || anel->sqes == MAP_FAILED) {
+        liberarAnel(entrada, anel);
+        free(anel);
+        return -1;
+    }
+
+    anel->sqCauda = (atomic_uint*)(anel->sq + p.sq_off.tail);
+    anel->sqIndices = (unsigned*)(anel->sq + p.sq_off.array);
+    anel->sqMascara = *(unsigned*)(anel->sq + p.sq_off.ring_mask);
+    anel->cqCabeca = (atomic_uint*)(anel->cq + p.cq_off.head);
+    anel->cqCauda = (atomic_uint*)(anel->cq + p.cq_off.tail);
+    anel->cqes = (struct io_uring_cqe*)(anel->cq + p.cq_off.cqes);
+    anel->cqMascara = *(unsigned*)(anel->cq + p.cq_off.ring_mask);
+    entrada->dados = anel;
+
+    // A primeira leitura já fica armada; dali em diante o kernel a completa sozinho
+    armarLeitura(entrada, anel);
+    if (submeterAnel(entrada, anel, 0) == -1) {
+        liberarAnel(entrada, anel);
+        free(anel);
+        entrada->dados = NULL;
+        return -1;
+    }
+    return 0;
+}
+
+static int lerUring(Entrada* entrada, char* tecla) {
+    Anel* anel = (Anel*)entrada->dados;
+    if (anel->inicio == anel->lidas)
+        colherAnel(anel);
+    if (anel->inicio < anel->lidas) {
+        *tecla = anel->teclas[anel->inicio++];
+        return 1;
+    }
+    if (anel->fim)
+        return -1;
+    // Buffer vazio: rearma a leitura junto com o que as conclusões enfileiraram
+    armarLeitura(entrada, anel);
+    if (submeterAnel(entrada, anel, 0) == -1)
+        anel->fim = 1;
+    return 0;
+}
+
+static int escreverUring(Entrada* entrada, int fd, const char* dados, size_t tamanho) {
+    Anel* anel = (Anel*)entrada->dados;
+    colherAnel(anel);
+    if (anel->escrevendo) {
+        // O quadro anterior ainda está saindo: este substitui o que estava na espera
+        copiarQuadro(&anel->proximo, &anel->capacidadeProximo, dados, tamanho);
+        anel->tamanhoProximo = tamanho;
+        anel->temProximo = 1;
+        return 0;
+    }
+    copiarQuadro(&anel->quadro, &anel->capacidadeQuadro, dados, tamanho);
+    anel->saida = fd;
+    anel->tamanhoQuadro = tamanho;
+    anel->enviados = 0;
+    enviarQuadro(anel);
+    armarLeitura(entrada, anel);
+    return submeterAnel(entrada, anel, 0);
+}
+
+static void descarregarUring(Entrada* entrada) {
+    Anel* anel = (Anel*)entrada->dados;
+    colherAnel(anel);
+    while (anel->escrevendo) {
+        if (submeterAnel(entrada, anel, 1) == -1)
+            return;
+        colherAnel(anel);
+    }
+}
+
+static void encerrarUring(Entrada* entrada) {
+    Anel* anel = (Anel*)entrada->dados;
+    // O kernel não pode escrever no buffer das teclas depois que ele for liberado
+    colherAnel(anel);
+    if (anel->lendo) {
+        enfileirarOperacao(anel, IORING_OP_ASYNC_CANCEL, -1, (const void*)(uintptr_t)OP_LEITURA, 0, OP_CANCELAR);
+        anel->cancelando = 1;
+    }
+    descarregarUring(entrada);
+    while (anel->lendo && anel->cancelando == 1) {
+        if (submeterAnel(entrada, anel, 1) == -1)
+            break;
+        colherAnel(anel);
+    }
+    liberarAnel(entrada, anel);
+    // Sem confirmação do cancelamento o buffer das teclas fica vivo, por via das dúvidas
+    if (!anel->lendo)
+        free(anel);
+}
+
+#else
+
+static int iniciarUring(Entrada* entrada) {
+    (void)entrada;
+    return -1;
+}
+
+#define lerUring NULL
+#define escreverUring NULL
+#define descarregarUring NULL
+#define encerrarUring NULL
+
+#endif
+
+// ---------------------------------------------------------------------------
+
+static const OperacoesEntrada ENTRADAS[] = {
+    {"inline", iniciarInline, lerInline, encerrarNada, escreverDireto, descarregarNada, NULL},
+    {"pipe", iniciarPipe, lerPipe, encerrarPipe, escreverDireto, descarregarNada, NULL},
+    {"thread", iniciarThread, lerFila, encerrarThread, escreverDireto, descarregarNada, NULL},
+    {"memoria", iniciarMemoria, lerFila, encerrarMemoria, escreverDireto, descarregarNada, NULL},
+    {"epoll", iniciarEpoll, lerEpoll, encerrarEpoll, escreverDireto, descarregarNada, NULL},
+    {"uring", iniciarUring, lerUring, encerrarUring, escreverUring, descarregarUring, "epoll"},
+};
+
+const char* const NOMES_ENTRADAS[] = {"inline", "pipe", "thread", "memoria", "epoll", "uring"};
+const int NUM_ENTRADAS = sizeof(ENTRADAS) / sizeof(ENTRADAS[0]);
+
+int criarEntrada(Entrada* entrada, const char* nome, int fd) {
+    memset(entrada, 0, sizeof(*entrada));
+    entrada->fd = fd;
+    entrada->aux = -1;
+    entrada->filho = -1;
+    for (int i = 0; i < NUM_ENTRADAS; i++) {
+        if (strcmp(ENTRADAS[i].nome, nome) == 0) {
+            entrada->ops = &ENTRADAS[i];
+            if (entrada->ops->iniciar(entrada) == 0)
+                return 0;
+            return ENTRADAS[i].alternativa != NULL ? criarEntrada(entrada, ENTRADAS[i].alternativa, fd) : -1;
+        }
+    }
+    return -1;
+}
+
+int lerEntrada(Entrada* entrada, char* tecla) {
+    return entrada->ops->ler(entrada, tecla);
+}
+
+void encerrarEntrada(Entrada* entrada) {
+    entrada->ops->encerrar(entrada);
+}
+
+int escreverQuadro(Entrada* entrada, int fd, const char* quadro, size_t tamanho) {
+    return entrada->ops->escrever(entrada, fd, quadro, tamanho);
+}
+
+void descarregarSaida(Entrada* entrada) {
+    entrada->ops->descarregar(entrada);
+}
+
+const char* nomeEntrada(const Entrada* entrada) {
+    return entrada->ops->nome;
+}
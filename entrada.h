@@ -0,0 +1,70 @@
+#ifndef ENTRADA_H
+#define ENTRADA_H
+
+#include <stdatomic.h>
+#include <stddef.h>
+#include <sys/types.h>
+
+// Backends de entrada/IPC: como as teclas chegam de um descritor até o laço do jogo
+//   inline  - o próprio laço consulta o descritor com select (como lets.c)
+//   pipe    - processo filho lê as teclas e repassa por um pipe (como pipes.c)
+//   thread  - thread leitora empurra as teclas numa fila SPSC sem trava
+//   memoria - processo filho empurra as teclas numa fila SPSC em memória compartilhada
+//   epoll   - o laço consulta o descritor com epoll_wait sem espera
+//   uring   - leitura e escrita do quadro são operações num io_uring; o laço só
+//             olha as conclusões e faz um io_uring_enter para o que acumulou.
+//             Sem io_uring no kernel (ou sem permissão) cai para o epoll.
+
+// Fila circular de um produtor e um consumidor; cabe numa página compartilhada
+#define TAMANHO_FILA 256
+
+typedef struct {
+    _Alignas(64) atomic_ulong cabeca; // Próxima posição a ser lida (consumidor)
+    _Alignas(64) atomic_ulong cauda;  // Próxima posição a ser escrita (produtor)
+    atomic_int fim;                   // O produtor viu o fim da entrada
+    atomic_int parar;                 // O consumidor pediu para o produtor parar
+    char teclas[TAMANHO_FILA];
+} FilaSPSC;
+
+typedef struct Entrada Entrada;
+
+typedef struct {
+    const char* nome;
+    int (*iniciar)(Entrada* entrada);
+    int (*ler)(Entrada* entrada, char* tecla);
+    void (*encerrar)(Entrada* entrada);
+    int (*escrever)(Entrada* entrada, int fd, const char* dados, size_t tamanho);
+    void (*descarregar)(Entrada* entrada);
+    const char* alternativa; // Backend usado quando este não consegue iniciar, ou NULL
+} OperacoesEntrada;
+
+struct Entrada {
+    const OperacoesEntrada* ops;
+    int fd;        // Descritor de onde as teclas vêm (stdin no jogo, um pipe no bench)
+    int aux;       // Descritor próprio do backend (leitura do pipe, epoll), ou -1
+    pid_t filho;   // Processo leitor dos backends com fork, ou -1
+    FilaSPSC* fila;
+    void* dados;
+};
+
+extern const char* const NOMES_ENTRADAS[];
+extern const int NUM_ENTRADAS;
+
+// Cria o backend com o nome dado lendo teclas de fd; devolve -1 se o nome não existe ou se falhar
+int criarEntrada(Entrada* entrada, const char* nome, int fd);
+
+// Não bloqueia: devolve 1 se leu uma tecla, 0 se não há tecla e -1 se a entrada acabou
+int lerEntrada(Entrada* entrada, char* tecla);
+
+void encerrarEntrada(Entrada* entrada);
+
+// Escreve um quadro inteiro em fd. No uring a escrita vai para o anel e a função volta
+// sem esperar; se o quadro anterior ainda não saiu, só o mais recente fica na espera.
+int escreverQuadro(Entrada* entrada, int fd, const char* quadro, size_t tamanho);
+
+// Espera as escritas pendentes; chamar antes de misturar printf com escreverQuadro
+void descarregarSaida(Entrada* entrada);
+
+const char* nomeEntrada(const Entrada* entrada);
+
+#endif
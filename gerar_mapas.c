@@ -0,0 +1,67 @@
+// Gera mapas grandes para os testes de desempenho (ver o alvo bench_mapas)
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "mapa.h"
+
+int main(int argc, char* argv[]) {
+    int largura = 1024, altura = 1024, contorno = 0, pares = 16;
+    double obstaculos = 0.05;
+    uint64_t semente = 1;
+    int opcao;
+
+    while ((opcao = getopt(argc, argv, "l:a:co:p:s:h")) != -1) {
+        switch (opcao) {
+            case 'l':
+                largura = atoi(optarg);
+                break;
+            case 'a':
+                altura = atoi(optarg);
+                break;
+            case 'c':
+                contorno = 1;
+                break;
+            case 'o':
+                obstaculos = atof(optarg);
+                break;
+            case 'p':
+                pares = atoi(optarg);
+                break;
+            case 's':
+                semente = strtoull(optarg, NULL, 10);
+                break;
+            default:
+                fprintf(stderr, "Uso: %s [-l largura] [-a altura] [-c] [-o obstaculos] [-p pares] [-s semente] saida\n", argv[0]);
+                return opcao == 'h' ? EXIT_SUCCESS : EXIT_FAILURE;
+        }
+    }
+    if (optind != argc - 1) {
+        fprintf(stderr, "Informe o arquivo de saída.\n");
+        return EXIT_FAILURE;
+    }
+
+    size_t tamanho;
+    char* texto = gerarMapa(largura, altura, contorno, obstaculos, pares, semente, &tamanho);
+    if (texto == NULL) {
+        printf("Erro: Não foi possível alocar memória para o mapa.\n");
+        return EXIT_FAILURE;
+    }
+
+    // Confere que o mapa gerado compila antes de gravar
+    Mapa mapa;
+    if (lerMapaTexto(&mapa, texto, tamanho) == -1) {
+        free(texto);
+        return EXIT_FAILURE;
+    }
+    liberarMapa(&mapa);
+
+    FILE* arquivo = fopen(argv[optind], "w");
+    if (arquivo == NULL || fwrite(texto, 1, tamanho, arquivo) != tamanho || fclose(arquivo) != 0) {
+        perror(argv[optind]);
+        free(texto);
+        return EXIT_FAILURE;
+    }
+    free(texto);
+    return EXIT_SUCCESS;
+}
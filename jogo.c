@@ -0,0 +1,379 @@
+#include "jogo.h"
+
+#include <ctype.h>
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "sorteio.h"
+
+// Função para criar um novo nó
+Node* criarNode(int x, int y) {
+    Node* novoNode = (Node*)malloc(sizeof(Node));
+    if (novoNode == NULL) {
+        printf("Erro: Não foi possível alocar memória para um novo nó.\n");
+        exit(EXIT_FAILURE);
+    }
+    novoNode->x = x;
+    novoNode->y = y;
+    novoNode->prox = NULL;
+    novoNode->ant = NULL;
+    return novoNode;
+}
+
+// Função para adicionar um novo nó no final da lista
+void append(Cobrinha* cobrinha, int x, int y) {
+    Node* novoNode = criarNode(x, y);
+    if (cobrinha->cabeca == NULL) {
+        cobrinha->cabeca = novoNode;
+        cobrinha->cauda = novoNode;
+    } else {
+        cobrinha->cauda->prox = novoNode;
+        novoNode->ant = cobrinha->cauda;
+        cobrinha->cauda = novoNode;
+    }
+}
+
+// Função para imprimir os elementos da lista
+void printLista(Cobrinha* cobrinha) {
+    Node* atual = cobrinha->cabeca;
+    while (atual != NULL) {
+        printf("(%d,%d) ", atual->x, atual->y);
+        atual = atual->prox;
+    }
+    printf("\n");
+}
+
+// Função para liberar a memória alocada para a lista
+void freeLista(Cobrinha* cobrinha) {
+    if (cobrinha->cabeca != NULL) {
+        Node* atual = cobrinha->cabeca;
+        Node* prox;
+        while (atual != NULL) {
+            prox = atual->prox;
+            free(atual);
+            atual = prox;
+        }
+        cobrinha->cabeca = NULL;
+        cobrinha->cauda = NULL;
+    }
+}
+
+void inicializarCobrinha(Cobrinha* cobrinha, int x, int y) {
+    append(cobrinha, x, y);
+    append(cobrinha, x - 1, y);
+    append(cobrinha, x - 2, y);
+}
+
+// Gerador xorshift64*: determinístico por partida, ao contrário de rand()
+static uint32_t sortear(Jogo* jogo) {
+    return xorshift64Estrela(&jogo->semente);
+}
+
+static int celulaLivre(const Jogo* jogo, int i) {
+    return tipoCelula(jogo->mapa, i) == CELULA_LIVRE && !bitLigado(jogo->ocupacao, i);
+}
+
+// Sorteia algumas células; se o mapa estiver quase cheio, varre a partir de um ponto sorteado
+static void sortearComida(Jogo* jogo) {
+    const Mapa* mapa = jogo->mapa;
+    int total = mapa->largura * mapa->altura;
+    int i = -1;
+    for (int tentativa = 0; tentativa < 64; tentativa++) {
+        int x = (int)(sortear(jogo) % (uint32_t)mapa->largura);
+        int y = (int)(sortear(jogo) % (uint32_t)mapa->altura);
+        if (celulaLivre(jogo, y * mapa->largura + x)) {
+            i = y * mapa->largura + x;
+            break;
+        }
+    }
+    if (i == -1) {
+        int inicio = (int)(sortear(jogo) % (uint32_t)total);
+        for (int k = 0; k < total && i == -1; k++) {
+            int candidata = (inicio + k) % total;
+            if (celulaLivre(jogo, candidata))
+                i = candidata;
+        }
+    }
+    jogo->comidaX = i == -1 ? SEM_COMIDA : i % mapa->largura;
+    jogo->comidaY = i == -1 ? SEM_COMIDA : i / mapa->largura;
+}
+
+void anexarSegmento(Jogo* jogo, int x, int y) {
+    append(&jogo->cobrinha, x, y);
+    ligarBit(jogo->ocupacao, y * jogo->mapa->largura + x);
+}
+
+// Estado de partida nova, com a ocupação já zerada
+static void comecarPartida(Jogo* jogo, uint64_t semente) {
+    const Mapa* mapa = jogo->mapa;
+    // O xorshift não sai do zero, então a semente nula é trocada por uma constante
+    jogo->semente = semente != 0 ? semente : 0x9E3779B97F4A7C15ULL;
+    jogo->direcao = DIREITA;
+    jogo->pontos = 0;
+    jogo->decorrido = 0;
+    for (int k = 0; k < 3; k++)
+        anexarSegmento(jogo, mapa->inicioX - k, mapa->inicioY);
+    sortearComida(jogo);
+}
+
+void prepararJogo(Jogo* jogo, const Mapa* mapa) {
+    memset(jogo, 0, sizeof(*jogo));
+    jogo->mapa = mapa;
+    jogo->comidaX = jogo->comidaY = SEM_COMIDA;
+    jogo->ocupacao = calloc(palavrasBitmap(mapa), sizeof(uint64_t));
+    if (jogo->ocupacao == NULL) {
+        printf("Erro: Não foi possível alocar memória para o mapa de ocupação.\n");
+        exit(EXIT_FAILURE);
+    }
+}
+
+void inicializarJogo(Jogo* jogo, const Mapa* mapa, uint64_t semente) {
+    prepararJogo(jogo, mapa);
+    comecarPartida(jogo, semente);
+}
+
+void esvaziarCobrinha(Jogo* jogo) {
+    for (Node* atual = jogo->cobrinha.cabeca; atual != NULL; atual = atual->prox)
+        desligarBit(jogo->ocupacao, atual->y * jogo->mapa->largura + atual->x);
+    freeLista(&jogo->cobrinha);
+}
+
+void reiniciarJogo(Jogo* jogo, uint64_t semente) {
+    esvaziarCobrinha(jogo);
+    comecarPartida(jogo, semente);
+}
+
+void finalizarJogo(Jogo* jogo) {
+    freeLista(&jogo->cobrinha);
+    free(jogo->ocupacao);
+    free(jogo->tela);
+    free(jogo->moldura);
+    jogo->ocupacao = NULL;
+    jogo->tela = NULL;
+    jogo->moldura = NULL;
+}
+
+void mudarDirecao(Jogo* jogo, char tecla) {
+    if (tecla == CIMA || tecla == BAIXO || tecla == ESQUERDA || tecla == DIREITA)
+        jogo->direcao = tecla;
+}
+
+// Início da célula (x, y) no quadro renderizado
+static size_t posicaoNoQuadro(const Mapa* mapa, int x, int y) {
+    size_t linha = 2 * (size_t)mapa->largura + sizeof(LIMPAR_LINHA);
+    return sizeof(CURSOR_INICIO) - 1 + (size_t)y * linha + 2 * (size_t)x;
+}
+
+static void pintarCelula(char* quadro, const Mapa* mapa, int x, int y, char c) {
+    char* celula = quadro + posicaoNoQuadro(mapa, x, y);
+    celula[0] = c;
+    celula[1] = c;
+}
+
+// Quadro só com o fundo do mapa: cada célula em duas colunas e as sequências do
+// terminal já no lugar. Montado no primeiro renderizarTela; os seguintes só o copiam
+static void montarMoldura(Jogo* jogo) {
+    const Mapa* mapa = jogo->mapa;
+    size_t tamanho = tamanhoQuadro(mapa);
+    jogo->moldura = malloc(tamanho);
+    if (jogo->moldura == NULL) {
+        printf("Erro: Não foi possível alocar memória para a moldura do quadro.\n");
+        exit(EXIT_FAILURE);
+    }
+    char* p = jogo->moldura;
+    memcpy(p, CURSOR_INICIO, sizeof(CURSOR_INICIO) - 1);
+    p += sizeof(CURSOR_INICIO) - 1;
+    for (int y = 0; y < mapa->altura; y++) {
+        const char* linha = mapa->fundo + (size_t)y * mapa->largura;
+        for (int x = 0; x < mapa->largura; x++) {
+            *p++ = linha[x];
+            *p++ = linha[x];
+        }
+        memcpy(p, LIMPAR_LINHA "\n", sizeof(LIMPAR_LINHA));
+        p += sizeof(LIMPAR_LINHA);
+    }
+    memcpy(p, LIMPAR_ABAIXO, sizeof(LIMPAR_ABAIXO) - 1);
+}
+
+int direcaoSegura(const Jogo* jogo, char direcao) {
+    const Mapa* mapa = jogo->mapa;
+    const Node* cabeca = jogo->cobrinha.cabeca;
+    int x, y;
+    return !proximaCelula(mapa, cabeca->x, cabeca->y, direcao, &x, &y) &&
+           !bitLigado(jogo->ocupacao, y * mapa->largura + x);
+}
+
+void montarTela(Jogo* jogo) {
+    const Mapa* mapa = jogo->mapa;
+    size_t celulas = (size_t)mapa->largura * mapa->altura;
+    if (jogo->tela == NULL) {
+        jogo->tela = malloc(celulas);
+        if (jogo->tela == NULL) {
+            printf("Erro: Não foi possível alocar memória para a tela.\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    // Paredes e portais já vêm desenhados no fundo pré-compilado do mapa
+    memcpy(jogo->tela, mapa->fundo, celulas);
+
+    // Adiciona os segmentos da cobrinha na tela
+    Node* atual = jogo->cobrinha.cabeca;
+    while (atual != NULL) {
+        jogo->tela[atual->y * mapa->largura + atual->x] = CORPO_COBRINHA;
+        atual = atual->prox;
+    }
+
+    if (jogo->comidaX != SEM_COMIDA)
+        jogo->tela[jogo->comidaY * mapa->largura + jogo->comidaX] = COMIDA;
+}
+
+unsigned atrasoPasso(const Jogo* jogo) {
+    if (jogo->curva == NULL)
+        return DELAY_HORIZONTAL;
+    int nivel = jogo->pontos < 0 ? 0 : jogo->pontos < NIVEIS_CURVA ? jogo->pontos : NIVEIS_CURVA - 1;
+    return jogo->curva->intervalos[nivel];
+}
+
+static int curvaInvalida(const char* especificacao, const char* motivo) {
+    fprintf(stderr, "Curva inválida '%s': %s\n", especificacao, motivo);
+    return -1;
+}
+
+int lerCurva(Curva* curva, const char* especificacao) {
+    char tipo[16];
+    unsigned inicial, minimo = 0;
+    double taxa = 0.0;
+    int inicioInicial = 0, inicioMinimo = 0;
+    int campos = sscanf(especificacao, "%15[^:]:%n%u:%n%u:%lf", tipo, &inicioInicial, &inicial,
+                        &inicioMinimo, &minimo, &taxa);
+    if (campos < 2 || inicial == 0)
+        return curvaInvalida(especificacao, "esperado 'tipo:inicial[:minimo:taxa]' com intervalos em microssegundos");
+    // %u aceita sinal e devolveria "-5" como um intervalo enorme; os intervalos são só dígitos
+    if (!isdigit((unsigned char)especificacao[inicioInicial]) ||
+        (campos >= 3 && !isdigit((unsigned char)especificacao[inicioMinimo])))
+        return curvaInvalida(especificacao, "intervalos não podem ser negativos");
+
+    int exponencial = strcmp(tipo, "exp") == 0;
+    if (strcmp(tipo, "constante") == 0) {
+        minimo = inicial;
+        taxa = 0.0;
+    } else if (!exponencial && strcmp(tipo, "linear") != 0) {
+        return curvaInvalida(especificacao, "tipo deve ser constante, linear ou exp");
+    } else if (campos < 4 || minimo == 0 || minimo > inicial) {
+        return curvaInvalida(especificacao, "mínimo deve ficar entre 1 e o intervalo inicial");
+    } else if (exponencial ? (taxa <= 0.0 || taxa > 1.0) : taxa < 0.0) {
+        return curvaInvalida(especificacao, exponencial ? "fator deve estar em (0, 1]" : "passo não pode ser negativo");
+    }
+
+    // Multiplicação ou subtração acumulada: nada de pow() por passo no laço do jogo
+    double intervalo = inicial;
+    for (int nivel = 0; nivel < NIVEIS_CURVA; nivel++) {
+        curva->intervalos[nivel] = intervalo > minimo ? (unsigned)(intervalo + 0.5) : minimo;
+        intervalo = exponencial ? intervalo * taxa : intervalo - taxa;
+    }
+    return 0;
+}
+
+static uint64_t relogioMonotonico(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+void iniciarRitmo(Ritmo* ritmo) {
+    ritmo->prazo = relogioMonotonico();
+    ritmo->perdidos = 0;
+}
+
+void agendarPasso(Ritmo* ritmo, unsigned intervalo) {
+    ritmo->prazo += (uint64_t)intervalo * 1000;
+    uint64_t instante = relogioMonotonico();
+    if (instante > ritmo->prazo) {
+        ritmo->prazo = instante;
+        ritmo->perdidos++;
+    }
+}
+
+int passoAtrasado(const Ritmo* ritmo) {
+    return relogioMonotonico() >= ritmo->prazo;
+}
+
+uint64_t esperarPasso(const Ritmo* ritmo) {
+    struct timespec ts = {(time_t)(ritmo->prazo / 1000000000ULL), (long)(ritmo->prazo % 1000000000ULL)};
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) == EINTR)
+        ;
+    uint64_t instante = relogioMonotonico();
+    return instante > ritmo->prazo ? instante - ritmo->prazo : 0;
+}
+
+ResultadoPasso passoJogo(Jogo* jogo) {
+    const Mapa* mapa = jogo->mapa;
+    Cobrinha* cobrinha = &jogo->cobrinha;
+    jogo->decorrido += atrasoPasso(jogo);
+
+    // Checa se a cobrinha colidiu com a parede ou consigo mesma: uma consulta a cada bitmap.
+    // A cauda ainda conta como corpo, como no jogo original.
+    int x, y;
+    if (proximaCelula(mapa, cobrinha->cabeca->x, cobrinha->cabeca->y, jogo->direcao, &x, &y))
+        return PASSO_FIM;
+    int i = y * mapa->largura + x;
+    if (bitLigado(jogo->ocupacao, i))
+        return PASSO_FIM;
+
+    // Move a cobrinha
+    Node* temp = criarNode(x, y);
+    temp->prox = cobrinha->cabeca;
+    cobrinha->cabeca->ant = temp;
+    cobrinha->cabeca = temp;
+    ligarBit(jogo->ocupacao, i);
+
+    // Checa se a cobrinha comeu a comida
+    if(x == jogo->comidaX && y == jogo->comidaY) {
+        jogo->pontos++;
+        sortearComida(jogo);
+        return PASSO_COMEU;
+    }
+
+    // Sem comida a cauda anda junto com a cabeça
+    Node* penultimo = cobrinha->cauda->ant;
+    desligarBit(jogo->ocupacao, cobrinha->cauda->y * mapa->largura + cobrinha->cauda->x);
+    free(cobrinha->cauda);
+    penultimo->prox = NULL;
+    cobrinha->cauda = penultimo;
+    return PASSO_MOVEU;
+}
+
+Relogio relogioJogo(const Jogo* jogo) {
+    uint64_t segundos = jogo->decorrido / 1000000;
+    Relogio relogio = {(int)(segundos / 60), (int)(segundos % 60)};
+    return relogio;
+}
+
+int comprimentoCobrinha(const Jogo* jogo) {
+    int comprimento = 0;
+    for (Node* atual = jogo->cobrinha.cabeca; atual != NULL; atual = atual->prox)
+        comprimento++;
+    return comprimento;
+}
+
+size_t tamanhoQuadro(const Mapa* mapa) {
+    size_t linha = 2 * (size_t)mapa->largura + sizeof(LIMPAR_LINHA) - 1 + 1;
+    return sizeof(CURSOR_INICIO) - 1 + (size_t)mapa->altura * linha + sizeof(LIMPAR_ABAIXO) - 1;
+}
+
+size_t renderizarTela(Jogo* jogo, char* buffer) {
+    const Mapa* mapa = jogo->mapa;
+    size_t tamanho = tamanhoQuadro(mapa);
+    if (jogo->moldura == NULL)
+        montarMoldura(jogo);
+    memcpy(buffer, jogo->moldura, tamanho);
+    for (const Node* atual = jogo->cobrinha.cabeca; atual != NULL; atual = atual->prox)
+        pintarCelula(buffer, mapa, atual->x, atual->y, CORPO_COBRINHA);
+    if (jogo->comidaX != SEM_COMIDA)
+        pintarCelula(buffer, mapa, jogo->comidaX, jogo->comidaY, COMIDA);
+    return tamanho;
+}
@@ -0,0 +1,160 @@
+#ifndef JOGO_H
+#define JOGO_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "mapa.h"
+
+#define LARGURA 22 // Dimensões do mapa padrão
+#define ALTURA 12
+#define CORPO_COBRINHA '*'
+#define COMIDA '@'
+#define PAREDE '#'
+#define CIMA 'w'
+#define BAIXO 's'
+#define ESQUERDA 'a'
+#define DIREITA 'd'
+#define DELAY_HORIZONTAL 200000 // Intervalo entre passos sem curva de dificuldade
+
+// Sequências do quadro: o cursor volta ao canto e o quadro é reescrito por cima,
+// apagando só as sobras de cada linha e o que estiver abaixo, sem a tela piscar
+#define CURSOR_INICIO "\033[H"
+#define LIMPAR_LINHA "\033[K"
+#define LIMPAR_ABAIXO "\033[J"
+#define SEM_COMIDA -1
+
+// Curva de dificuldade: o intervalo entre passos cai com a pontuação
+#define NIVEIS_CURVA 256 // Pontuações com intervalo próprio; acima disso vale o último
+#define CURVA_PADRAO "exp:200000:8000:0.95"
+
+// Definição da estrutura do nó da lista
+typedef struct Node {
+    int x;
+    int y;
+    struct Node* prox;
+    struct Node* ant; // Segmento anterior (em direção à cabeça), para a cauda andar em O(1)
+} Node;
+
+// Definição da estrutura da cobra
+typedef struct {
+    Node* cabeca; // Aponta para a cabeça da cobra
+    Node* cauda; // Aponta para a cauda da cobra
+} Cobrinha;
+
+// Definição da estrutura para o relógio
+typedef struct {
+    int minutos;
+    int segundos;
+} Relogio;
+
+// Resultado de um passo do jogo
+typedef enum {
+    PASSO_MOVEU,  // A cobrinha andou uma casa
+    PASSO_COMEU,  // A cobrinha andou e comeu a comida
+    PASSO_FIM     // A cobrinha bateu na parede ou em si mesma
+} ResultadoPasso;
+
+// Intervalo em microssegundos para cada pontuação, calculado uma vez por lerCurva
+typedef struct {
+    unsigned intervalos[NIVEIS_CURVA];
+} Curva;
+
+// Relógio de passos com prazos absolutos: o tempo gasto desenhando não se soma ao
+// intervalo, e quem perde o prazo recomeça do agora em vez de correr atrás
+typedef struct {
+    uint64_t prazo;    // Instante do próximo passo em nanossegundos (CLOCK_MONOTONIC)
+    uint64_t perdidos; // Passos agendados quando o prazo já tinha passado (o jogo os mostra no fim)
+} Ritmo;
+
+// Estado completo de uma partida
+typedef struct {
+    const Mapa* mapa;
+    Cobrinha cobrinha;
+    uint64_t* ocupacao; // Bitmap das células ocupadas pelo corpo, um bit por célula do mapa
+    char* tela;         // Desenho do último montarTela, alocado na primeira chamada
+    char* moldura;      // Quadro renderizado só com o fundo, montado no primeiro renderizarTela
+    char direcao;
+    int comidaX;        // SEM_COMIDA quando não sobrou célula livre
+    int comidaY;
+    int pontos;
+    uint64_t decorrido; // Tempo de jogo em microssegundos (soma dos atrasos dos passos)
+    uint64_t semente;   // Estado do gerador pseudoaleatório da comida
+    const Curva* curva; // NULL é o ritmo constante de DELAY_HORIZONTAL; não é zerada ao reiniciar
+} Jogo;
+
+Node* criarNode(int x, int y);
+void append(Cobrinha* cobrinha, int x, int y);
+void printLista(Cobrinha* cobrinha);
+void freeLista(Cobrinha* cobrinha);
+void inicializarCobrinha(Cobrinha* cobrinha, int x, int y);
+
+// Prepara uma nova partida no mapa; a mesma semente sempre gera a mesma sequência de comidas.
+// O mapa precisa durar tanto quanto a partida.
+void inicializarJogo(Jogo* jogo, const Mapa* mapa, uint64_t semente);
+void finalizarJogo(Jogo* jogo);
+
+// Começa outra partida no mesmo mapa reaproveitando as alocações: custa
+// O(comprimento) em vez de O(tamanho do mapa)
+void reiniciarJogo(Jogo* jogo, uint64_t semente);
+
+// Aloca a partida no mapa sem cobrinha nem comida, para quem vai montar o estado
+// (restauração de snapshots); a ocupação vem zerada sem ser percorrida
+void prepararJogo(Jogo* jogo, const Mapa* mapa);
+
+// Tira a cobrinha da partida desligando só as células do corpo: O(comprimento)
+void esvaziarCobrinha(Jogo* jogo);
+
+// Acrescenta um segmento na cauda e marca sua célula como ocupada (usado ao restaurar snapshots)
+void anexarSegmento(Jogo* jogo, int x, int y);
+
+// Troca a direção da cobrinha; teclas que não são de movimento são ignoradas
+void mudarDirecao(Jogo* jogo, char tecla);
+
+// 1 se o próximo passo na direção não bate em parede nem no corpo (a cauda ainda
+// conta como corpo, como em passoJogo); usado pelos jogadores automáticos
+int direcaoSegura(const Jogo* jogo, char direcao);
+
+// Desenha mapa, cobrinha e comida em jogo->tela, uma célula por caractere, para quem
+// imprime a grade por conta própria; renderizarTela não precisa dela
+void montarTela(Jogo* jogo);
+
+// Move a cobrinha uma casa e aplica colisões e comida; não depende da tela.
+// Numa colisão a cobrinha fica onde estava.
+ResultadoPasso passoJogo(Jogo* jogo);
+
+// Atraso em microssegundos até o próximo passo: uma consulta à tabela da curva.
+// É o mesmo em qualquer direção; a proporção da tela fica com o renderizador.
+unsigned atrasoPasso(const Jogo* jogo);
+
+// Lê "constante:inicial", "linear:inicial:minimo:passo" (passo em microssegundos a
+// menos por ponto) ou "exp:inicial:minimo:fator" (intervalo multiplicado por fator a
+// cada ponto) e pré-calcula a tabela; devolve -1 e escreve o motivo em stderr se inválida
+int lerCurva(Curva* curva, const char* especificacao);
+
+void iniciarRitmo(Ritmo* ritmo);
+
+// Marca o próximo passo intervalo microssegundos depois do anterior
+void agendarPasso(Ritmo* ritmo, unsigned intervalo);
+
+// O prazo do próximo passo já chegou: não há tempo para desenhar
+int passoAtrasado(const Ritmo* ritmo);
+
+// Dorme até o prazo do próximo passo; devolve com quantos nanossegundos de atraso acordou
+uint64_t esperarPasso(const Ritmo* ritmo);
+
+Relogio relogioJogo(const Jogo* jogo);
+
+// Número de segmentos da cobrinha (percorre a lista)
+int comprimentoCobrinha(const Jogo* jogo);
+
+// Bytes do quadro renderizado: cada célula ocupa duas colunas, para compensar
+// caracteres de terminal que são duas vezes mais altos que largos
+size_t tamanhoQuadro(const Mapa* mapa);
+
+// Escreve o quadro em buffer (pelo menos tamanhoQuadro bytes) e devolve quantos bytes usou:
+// copia a moldura inteira (um memcpy do tamanho do quadro) e pinta por cima a cobrinha
+// e a comida, em O(comprimento). A primeira chamada monta a moldura.
+size_t renderizarTela(Jogo* jogo, char* buffer);
+
+#endif
@@ -131,6 +131,9 @@ int main() {
         Cobrinha cobrinha = {NULL, NULL}; // Inicializa a cobra com a cabeça e a cauda como NULL
         inicializarCobrinha(&cobrinha);
         direcao = DIREITA;
+        pontos = 0; // Cada partida começa do zero, com comida nova
+        comidaX = 0;
+        comidaY = 0;
 
         while(1) {
             // Inicializa a tela
@@ -198,15 +201,21 @@ int main() {
                 break;
             }
 
+            // O break só sairia do laço que percorre o corpo; a flag encerra a partida
+            int colidiu = 0;
             atual = cobrinha.cabeca->prox;
             while (atual != NULL) {
                 if (atual->x == cobrinha.cabeca->x && atual->y == cobrinha.cabeca->y) {
-                    printf("Game Over! Score: %d\n", pontos);
-                    freeLista(&cobrinha);
+                    colidiu = 1;
                     break;
                 }
                 atual = atual->prox;
             }
+            if (colidiu) {
+                printf("Game Over! Score: %d\n", pontos);
+                freeLista(&cobrinha);
+                break;
+            }
 
             // Check se a cobrinha comeu a comida
             if(cobrinha.cabeca->x == comidaX && cobrinha.cabeca->y == comidaY) {
@@ -220,6 +229,7 @@ int main() {
                 }
                 free(temp->prox);
                 temp->prox = NULL;
+                cobrinha.cauda = temp;
             }
         }
 
@@ -0,0 +1,303 @@
+#include "mapa.h"
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "binario.h"
+#include "jogo.h"
+#include "sorteio.h"
+
+#define LADO_MAXIMO 16384
+#define NUM_PORTAIS 36
+
+static const char IDS_PORTAIS[NUM_PORTAIS + 1] = "0123456789abcdefghijklmnopqrstuvwxyz";
+
+static int idPortal(char c) {
+    if (c >= '0' && c <= '9')
+        return c - '0';
+    if (c >= 'a' && c <= 'z')
+        return 10 + c - 'a';
+    return -1;
+}
+
+static void marcarCelula(Mapa* mapa, int i, int tipo) {
+    mapa->celulas[i >> 5] |= (uint64_t)tipo << ((i & 31) * 2);
+}
+
+static int compararPortais(const void* a, const void* b) {
+    return ((const Portal*)a)->origem - ((const Portal*)b)->origem;
+}
+
+// Devolve o início da próxima linha e o tamanho da atual sem '\n' nem '\r'
+static const char* proximaLinha(const char* p, const char* fim, size_t* tamanho) {
+    const char* quebra = memchr(p, '\n', (size_t)(fim - p));
+    const char* final = quebra != NULL ? quebra : fim;
+    *tamanho = (size_t)(final - p);
+    if (*tamanho > 0 && p[*tamanho - 1] == '\r')
+        (*tamanho)--;
+    return quebra != NULL ? quebra + 1 : fim;
+}
+
+static int mapaInvalido(Mapa* mapa, const char* motivo, int linha) {
+    if (linha > 0)
+        fprintf(stderr, "Mapa inválido (linha %d): %s\n", linha, motivo);
+    else
+        fprintf(stderr, "Mapa inválido: %s\n", motivo);
+    liberarMapa(mapa);
+    return -1;
+}
+
+int lerMapaTexto(Mapa* mapa, const char* texto, size_t tamanho) {
+    memset(mapa, 0, sizeof(*mapa));
+    const char* fim = texto + tamanho;
+    size_t n;
+    const char* p = proximaLinha(texto, fim, &n);
+
+    char cabecalho[128], opcao[32] = "";
+    if (n >= sizeof(cabecalho))
+        return mapaInvalido(mapa, "cabeçalho longo demais", 1);
+    memcpy(cabecalho, texto, n);
+    cabecalho[n] = '\0';
+    int campos = sscanf(cabecalho, "MAPA %d %d %31s", &mapa->largura, &mapa->altura, opcao);
+    if (campos < 2)
+        return mapaInvalido(mapa, "esperado 'MAPA <largura> <altura> [contorno]'", 1);
+    if (mapa->largura < 3 || mapa->altura < 1 || mapa->largura > LADO_MAXIMO || mapa->altura > LADO_MAXIMO)
+        return mapaInvalido(mapa, "dimensões fora do limite", 1);
+    if (campos == 3) {
+        if (strcmp(opcao, "contorno") != 0)
+            return mapaInvalido(mapa, "opção desconhecida", 1);
+        mapa->contorno = 1;
+    }
+
+    int largura = mapa->largura;
+    size_t celulas = (size_t)largura * mapa->altura;
+    mapa->celulas = calloc((celulas + 31) / 32, sizeof(uint64_t));
+    mapa->fundo = malloc(celulas);
+    mapa->portais = malloc(2 * NUM_PORTAIS * sizeof(Portal));
+    if (mapa->celulas == NULL || mapa->fundo == NULL || mapa->portais == NULL)
+        return mapaInvalido(mapa, "sem memória", 0);
+    memset(mapa->fundo, CHAR_LIVRE, celulas);
+
+    int pares[NUM_PORTAIS][2];
+    for (int i = 0; i < NUM_PORTAIS; i++)
+        pares[i][0] = pares[i][1] = -1;
+    mapa->inicioX = -1;
+
+    for (int y = 0; y < mapa->altura; y++) {
+        if (p >= fim)
+            return mapaInvalido(mapa, "faltam linhas", y + 2);
+        const char* linha = p;
+        p = proximaLinha(p, fim, &n);
+        if (n > (size_t)largura)
+            return mapaInvalido(mapa, "linha mais larga que o mapa", y + 2);
+
+        // Linhas mais curtas são completadas com células livres
+        for (int x = 0; x < (int)n; x++) {
+            char c = linha[x];
+            int i = y * largura + x;
+            int id = idPortal(c);
+            if (c == PAREDE) {
+                marcarCelula(mapa, i, CELULA_PAREDE);
+                mapa->fundo[i] = PAREDE;
+            } else if (c == CHAR_INICIO) {
+                if (mapa->inicioX != -1)
+                    return mapaInvalido(mapa, "mais de um 'S'", y + 2);
+                mapa->inicioX = x;
+                mapa->inicioY = y;
+            } else if (id >= 0) {
+                int lado = pares[id][0] == -1 ? 0 : 1;
+                if (pares[id][lado] != -1)
+                    return mapaInvalido(mapa, "portal com mais de duas pontas", y + 2);
+                pares[id][lado] = i;
+                marcarCelula(mapa, i, CELULA_PORTAL);
+                mapa->fundo[i] = c;
+            } else if (c != CHAR_LIVRE && c != '.') {
+                return mapaInvalido(mapa, "caractere desconhecido", y + 2);
+            }
+        }
+    }
+
+    for (int id = 0; id < NUM_PORTAIS; id++) {
+        if (pares[id][0] == -1)
+            continue;
+        if (pares[id][1] == -1)
+            return mapaInvalido(mapa, "portal sem par", 0);
+        mapa->portais[mapa->numPortais++] = (Portal){pares[id][0], pares[id][1]};
+        mapa->portais[mapa->numPortais++] = (Portal){pares[id][1], pares[id][0]};
+    }
+    qsort(mapa->portais, mapa->numPortais, sizeof(Portal), compararPortais);
+
+    if (mapa->inicioX == -1) {
+        mapa->inicioX = largura / 2;
+        mapa->inicioY = mapa->altura / 2;
+    }
+    // A cobrinha nasce com três segmentos à esquerda da cabeça
+    for (int k = 0; k < 3; k++) {
+        int x = mapa->inicioX - k;
+        if (x < 0 || tipoCelula(mapa, mapa->inicioY * largura + x) != CELULA_LIVRE)
+            return mapaInvalido(mapa, "sem espaço livre para a cobrinha nascer", 0);
+    }
+
+    uint32_t h = FNV1A_INICIAL;
+    h = fnv1a(h, &mapa->largura, sizeof(int));
+    h = fnv1a(h, &mapa->altura, sizeof(int));
+    h = fnv1a(h, &mapa->contorno, sizeof(int));
+    h = fnv1a(h, mapa->celulas, (celulas + 31) / 32 * sizeof(uint64_t));
+    h = fnv1a(h, mapa->portais, (size_t)mapa->numPortais * sizeof(Portal));
+    mapa->id = h;
+    return 0;
+}
+
+int carregarMapa(Mapa* mapa, const char* caminho) {
+    int fd = open(caminho, O_RDONLY);
+    if (fd == -1) {
+        perror(caminho);
+        return -1;
+    }
+    struct stat info;
+    if (fstat(fd, &info) == -1 || info.st_size == 0) {
+        fprintf(stderr, "%s: arquivo vazio ou ilegível\n", caminho);
+        close(fd);
+        return -1;
+    }
+    char* texto = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (texto == MAP_FAILED) {
+        perror("mmap");
+        return -1;
+    }
+    madvise(texto, (size_t)info.st_size, MADV_SEQUENTIAL);
+    int resultado = lerMapaTexto(mapa, texto, (size_t)info.st_size);
+    munmap(texto, (size_t)info.st_size);
+    return resultado;
+}
+
+int mapaPadrao(Mapa* mapa) {
+    size_t tamanho;
+    char* texto = gerarMapa(LARGURA, ALTURA, 0, 0.0, 0, 0, &tamanho);
+    if (texto == NULL)
+        return -1;
+    int resultado = lerMapaTexto(mapa, texto, tamanho);
+    free(texto);
+    return resultado;
+}
+
+void liberarMapa(Mapa* mapa) {
+    free(mapa->celulas);
+    free(mapa->portais);
+    free(mapa->fundo);
+    mapa->celulas = NULL;
+    mapa->portais = NULL;
+    mapa->fundo = NULL;
+}
+
+char* gerarMapa(int largura, int altura, int contorno, double obstaculos, int pares, uint64_t semente, size_t* tamanho) {
+    char cabecalho[64];
+    int n = snprintf(cabecalho, sizeof(cabecalho), "MAPA %d %d%s\n", largura, altura, contorno ? " contorno" : "");
+    size_t total = (size_t)n + (size_t)(largura + 1) * altura;
+    char* texto = malloc(total + 1);
+    if (texto == NULL)
+        return NULL;
+    memcpy(texto, cabecalho, (size_t)n);
+
+    uint64_t estado = semente * 2 + 1;
+    char* grade = texto + n;
+    int meioX = largura / 2, meioY = altura / 2;
+    for (int y = 0; y < altura; y++) {
+        char* linha = grade + (size_t)y * (largura + 1);
+        for (int x = 0; x < largura; x++) {
+            xorshift64(&estado);
+            int borda = y == 0 || y == altura - 1 || x == 0 || x == largura - 1;
+            int nascimento = y == meioY && x >= meioX - 3 && x <= meioX + 3;
+            if (borda && !contorno)
+                linha[x] = PAREDE;
+            else if (!nascimento && (double)(estado >> 11) / 9007199254740992.0 < obstaculos)
+                linha[x] = PAREDE;
+            else
+                linha[x] = CHAR_LIVRE;
+        }
+        linha[largura] = '\n';
+    }
+
+    // Portais em células livres sorteadas, longe do ponto de nascimento
+    if (pares > NUM_PORTAIS)
+        pares = NUM_PORTAIS;
+    for (int id = 0; id < pares; id++) {
+        for (int ponta = 0; ponta < 2; ponta++) {
+            for (int tentativa = 0; tentativa < 1000; tentativa++) {
+                xorshift64(&estado);
+                int x = (int)(estado % (uint64_t)largura);
+                int y = (int)((estado >> 32) % (uint64_t)altura);
+                char* celula = grade + (size_t)y * (largura + 1) + x;
+                if (*celula == CHAR_LIVRE && y != meioY) {
+                    *celula = IDS_PORTAIS[id];
+                    break;
+                }
+            }
+        }
+    }
+
+    texto[total] = '\0';
+    *tamanho = total;
+    return texto;
+}
+
+int destinoPortal(const Mapa* mapa, int i) {
+    int baixo = 0, alto = mapa->numPortais - 1;
+    while (baixo <= alto) {
+        int meio = (baixo + alto) / 2;
+        if (mapa->portais[meio].origem == i)
+            return mapa->portais[meio].destino;
+        if (mapa->portais[meio].origem < i)
+            baixo = meio + 1;
+        else
+            alto = meio - 1;
+    }
+    return i;
+}
+
+int proximaCelula(const Mapa* mapa, int x, int y, char direcao, int* nx, int* ny) {
+    switch(direcao) {
+        case CIMA:
+            y--;
+            break;
+        case BAIXO:
+            y++;
+            break;
+        case ESQUERDA:
+            x--;
+            break;
+        case DIREITA:
+            x++;
+            break;
+    }
+
+    if ((unsigned)x >= (unsigned)mapa->largura) {
+        if (!mapa->contorno)
+            return 1;
+        x = x < 0 ? x + mapa->largura : x - mapa->largura;
+    }
+    if ((unsigned)y >= (unsigned)mapa->altura) {
+        if (!mapa->contorno)
+            return 1;
+        y = y < 0 ? y + mapa->altura : y - mapa->altura;
+    }
+
+    int i = y * mapa->largura + x;
+    int tipo = tipoCelula(mapa, i);
+    if (tipo == CELULA_PAREDE)
+        return 1;
+    if (tipo == CELULA_PORTAL) {
+        i = destinoPortal(mapa, i);
+        x = i % mapa->largura;
+        y = i / mapa->largura;
+    }
+    *nx = x;
+    *ny = y;
+    return 0;
+}
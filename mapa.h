@@ -0,0 +1,82 @@
+#ifndef MAPA_H
+#define MAPA_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Formato texto dos mapas:
+//   primeira linha: MAPA <largura> <altura> [contorno]
+//   depois <altura> linhas com '#' parede, ' ' ou '.' livre, 'S' cabeça inicial
+//   (a cobrinha nasce virada para a direita com o corpo à esquerda) e portais
+//   '0'-'9'/'a'-'z', sempre em pares: quem entra em um sai pelo outro.
+// Com "contorno" quem sai por uma borda entra pela oposta; sem ele sair é bater.
+#define CHAR_LIVRE ' '
+#define CHAR_INICIO 'S'
+
+#define CELULA_LIVRE 0
+#define CELULA_PAREDE 1
+#define CELULA_PORTAL 2
+
+typedef struct {
+    int origem;  // Índice (y * largura + x) da célula do portal
+    int destino; // Índice da célula do portal par
+} Portal;
+
+typedef struct {
+    int largura;
+    int altura;
+    int contorno;      // 1 se as bordas dão a volta
+    int inicioX;
+    int inicioY;
+    uint64_t* celulas; // Bitmap pré-compilado, 2 bits por célula (CELULA_*)
+    Portal* portais;   // Ordenados por origem
+    int numPortais;
+    char* fundo;       // Desenho do mapa sem cobrinha e comida, largura * altura
+    uint32_t id;       // Impressão digital do mapa, conferida pelos snapshots
+} Mapa;
+
+// Tipo da célula no índice i: uma única consulta ao bitmap
+static inline int tipoCelula(const Mapa* mapa, int i) {
+    return (int)((mapa->celulas[i >> 5] >> ((i & 31) * 2)) & 3);
+}
+
+// Bitmaps de um bit por célula (ocupação do corpo)
+static inline int bitLigado(const uint64_t* bits, int i) {
+    return (int)((bits[i >> 6] >> (i & 63)) & 1);
+}
+
+static inline void ligarBit(uint64_t* bits, int i) {
+    bits[i >> 6] |= 1ULL << (i & 63);
+}
+
+static inline void desligarBit(uint64_t* bits, int i) {
+    bits[i >> 6] &= ~(1ULL << (i & 63));
+}
+
+// Compila um mapa a partir do texto; devolve -1 e escreve o motivo em stderr se for inválido
+int lerMapaTexto(Mapa* mapa, const char* texto, size_t tamanho);
+
+// Lê o arquivo via mmap e compila; o arquivo não fica mapeado depois
+int carregarMapa(Mapa* mapa, const char* caminho);
+
+// Mapa original: LARGURA x ALTURA com parede na borda
+int mapaPadrao(Mapa* mapa);
+
+void liberarMapa(Mapa* mapa);
+
+// Gera o texto de um mapa com paredes na borda (ou contorno), uma fração de
+// obstáculos e pares de portais; devolve um buffer alocado com malloc
+char* gerarMapa(int largura, int altura, int contorno, double obstaculos, int pares, uint64_t semente, size_t* tamanho);
+
+// Anda uma casa de (x, y) na direção dada aplicando contorno e portais.
+// Devolve 1 se bateu na parede ou saiu de um mapa sem contorno.
+int proximaCelula(const Mapa* mapa, int x, int y, char direcao, int* nx, int* ny);
+
+// Índice da outra ponta do portal na célula i
+int destinoPortal(const Mapa* mapa, int i);
+
+static inline size_t palavrasBitmap(const Mapa* mapa) {
+    return ((size_t)mapa->largura * mapa->altura + 63) / 64;
+}
+
+#endif
@@ -0,0 +1,110 @@
+#include "medidas.h"
+
+#include <signal.h>
+#include <stdio.h>
+#include <sys/ptrace.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+unsigned long long agora(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (unsigned long long)ts.tv_sec * 1000000000ULL + (unsigned long long)ts.tv_nsec;
+}
+
+// Faixa 0 guarda 0..15 exatos; a faixa f > 0 cobre [16 << (f - 1), 16 << f)
+void registrarHistograma(Histograma* histograma, unsigned long long valor) {
+    int faixa = 0;
+    int sub = (int)valor;
+    if (valor >= SUBFAIXAS) {
+        int bit = 63 - __builtin_clzll(valor);
+        faixa = bit - 3;
+        sub = (int)((valor >> (bit - 4)) & (SUBFAIXAS - 1));
+    }
+    histograma->contagem[faixa][sub]++;
+    histograma->total++;
+    if (valor > histograma->maximo)
+        histograma->maximo = valor;
+}
+
+void juntarHistogramas(Histograma* destino, const Histograma* origem) {
+    for (int f = 0; f < FAIXAS; f++)
+        for (int s = 0; s < SUBFAIXAS; s++)
+            destino->contagem[f][s] += origem->contagem[f][s];
+    destino->total += origem->total;
+    if (origem->maximo > destino->maximo)
+        destino->maximo = origem->maximo;
+}
+
+unsigned long long percentilHistograma(const Histograma* histograma, double p) {
+    if (histograma->total == 0)
+        return 0;
+    unsigned long long alvo = (unsigned long long)(p * histograma->total);
+    if (alvo >= histograma->total)
+        return histograma->maximo;
+
+    unsigned long long acumulado = 0;
+    for (int f = 0; f < FAIXAS; f++) {
+        for (int s = 0; s < SUBFAIXAS; s++) {
+            acumulado += histograma->contagem[f][s];
+            if (acumulado > alvo) {
+                if (f == 0)
+                    return (unsigned long long)s;
+                // Devolve o limite superior da subfaixa, nunca acima do máximo visto
+                unsigned long long limite = ((unsigned long long)(SUBFAIXAS + s + 1) << (f - 1)) - 1;
+                return limite < histograma->maximo ? limite : histograma->maximo;
+            }
+        }
+    }
+    return histograma->maximo;
+}
+
+long memoriaResidente(void) {
+    FILE* arquivo = fopen("/proc/self/statm", "r");
+    if (arquivo == NULL)
+        return -1;
+    long total, residente;
+    int lidos = fscanf(arquivo, "%ld %ld", &total, &residente);
+    fclose(arquivo);
+    if (lidos != 2)
+        return -1;
+    return residente * (sysconf(_SC_PAGESIZE) / 1024);
+}
+
+long contarChamadasSistema(pid_t filho) {
+    // Com WUNTRACED a parada é vista mesmo que o filho não esteja sendo seguido (e aí
+    // PTRACE_SETOPTIONS falha e ele é morto abaixo); sem rastreio ele sai e é colhido aqui
+    int status;
+    if (waitpid(filho, &status, WUNTRACED) != filho || WIFEXITED(status) || WIFSIGNALED(status))
+        return -1;
+    long opcoes = PTRACE_O_TRACESYSGOOD | PTRACE_O_TRACEFORK | PTRACE_O_TRACEVFORK |
+                  PTRACE_O_TRACECLONE | PTRACE_O_TRACEEXEC | PTRACE_O_EXITKILL;
+    if (ptrace(PTRACE_SETOPTIONS, filho, NULL, (void*)opcoes) == -1 ||
+        ptrace(PTRACE_SYSCALL, filho, NULL, NULL) == -1) {
+        kill(filho, SIGKILL);
+        waitpid(filho, NULL, 0);
+        return -1;
+    }
+
+    long chamadas = 0;
+    pid_t pid;
+    // Segue até não sobrar ninguém: o filho e quem ele criou
+    while ((pid = waitpid(-1, &status, __WALL)) != -1) {
+        if (!WIFSTOPPED(status))
+            continue;
+        int sinal = WSTOPSIG(status);
+        if (sinal == (SIGTRAP | 0x80)) {
+            // Cada chamada para duas vezes, na entrada e na saída; só a entrada conta
+            struct __ptrace_syscall_info info;
+            if (ptrace(PTRACE_GET_SYSCALL_INFO, pid, (void*)sizeof(info), &info) > 0 &&
+                info.op == PTRACE_SYSCALL_INFO_ENTRY)
+                chamadas++;
+            sinal = 0;
+        } else if (sinal == SIGTRAP || sinal == SIGSTOP) {
+            sinal = 0; // Eventos de fork/clone/exec e a parada inicial de quem nasceu seguido
+        }
+        ptrace(PTRACE_SYSCALL, pid, NULL, (void*)(long)sinal);
+    }
+    return chamadas;
+}
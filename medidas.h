@@ -0,0 +1,40 @@
+#ifndef MEDIDAS_H
+#define MEDIDAS_H
+
+#include <sys/types.h>
+
+// Ferramentas de medição compartilhadas pelo bench e pelo soak
+
+// Histograma log-linear: 16 subfaixas por potência de dois (erro relativo de ~6%),
+// tamanho fixo, para guardar milhões de amostras sem alocar
+#define SUBFAIXAS 16
+#define FAIXAS 61
+
+typedef struct {
+    unsigned long long contagem[FAIXAS][SUBFAIXAS];
+    unsigned long long total;
+    unsigned long long maximo;
+} Histograma;
+
+// Relógio monotônico em nanossegundos
+unsigned long long agora(void);
+
+void registrarHistograma(Histograma* histograma, unsigned long long valor);
+void juntarHistogramas(Histograma* destino, const Histograma* origem);
+
+// Valor abaixo do qual está a fração p (0 a 1) das amostras
+unsigned long long percentilHistograma(const Histograma* histograma, double p);
+
+// Memória residente do processo em KB, ou -1 se /proc não estiver disponível
+long memoriaResidente(void);
+
+// Status com que o filho sai quando PTRACE_TRACEME falha, em vez de parar com SIGSTOP
+// sem ninguém para retomá-lo
+#define SAIDA_SEM_RASTREIO 126
+
+// Segue via ptrace o filho (que chamou PTRACE_TRACEME e parou com SIGSTOP) e todos os
+// processos e threads que ele criar até o filho terminar; devolve quantas chamadas de
+// sistema fizeram, ou -1 se ptrace não estiver disponível (o filho saiu sem parar)
+long contarChamadasSistema(pid_t filho);
+
+#endif
@@ -282,6 +282,7 @@ int main() {
                 }
                 free(temp->prox);
                 temp->prox = NULL;
+                cobrinha.cauda = temp;
             }
         }
 
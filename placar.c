@@ -0,0 +1,475 @@
+#include "placar.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "binario.h"
+
+// Log (inteiros em little-endian):
+//   cabeçalho: 0 "COP" + versão   4 tamanho do registro
+//   registro:  0 pontos   4 comprimento   8 duração   16 replay   24 id do mapa
+//              28 FNV-1a de 32 bits dos 28 bytes anteriores
+// Índice:
+//   cabeçalho: 0 "COI" + versão   4 entradas   8 registros cobertos
+//              16 soma do último registro coberto (amarra o índice ao log)
+//              20 registros corrompidos entre os cobertos   24 reservado
+//              28 FNV-1a dos 28 bytes anteriores
+//   entradas:  0 pontos   4 posição no log, da maior pontuação para a menor
+static const unsigned char MAGICO_LOG[4] = {'C', 'O', 'P', 1};
+static const unsigned char MAGICO_INDICE[4] = {'C', 'O', 'I', 1};
+#define CABECALHO_LOG 8
+#define TAMANHO_REGISTRO 32
+#define CABECALHO_INDICE 32
+#define TAMANHO_ENTRADA 8
+#define LIMITE_RECENTES 4096 // Partidas fora do índice antes de compactar
+#define LOTE_LEITURA 4096    // Registros lidos por pread ao varrer o log
+
+static void codificarPartida(unsigned char* p, const Partida* partida) {
+    escrever32(p, (uint32_t)partida->pontos);
+    escrever32(p + 4, partida->comprimento);
+    escrever64(p + 8, partida->duracao);
+    escrever64(p + 16, partida->replay);
+    escrever32(p + 24, partida->mapa);
+    escrever32(p + 28, fnv1a(FNV1A_INICIAL, p, 28));
+}
+
+// Devolve -1 se o registro estiver rasgado ou corrompido
+static int decodificarPartida(const unsigned char* p, Partida* partida) {
+    if (ler32(p + 28) != fnv1a(FNV1A_INICIAL, p, 28))
+        return -1;
+    partida->pontos = (int)ler32(p);
+    partida->comprimento = ler32(p + 4);
+    partida->duracao = ler64(p + 8);
+    partida->replay = ler64(p + 16);
+    partida->mapa = ler32(p + 24);
+    return 0;
+}
+
+// Ordem do placar: mais pontos primeiro e, no empate, a partida mais antiga
+static int antes(EntradaPlacar a, EntradaPlacar b) {
+    return a.pontos > b.pontos || (a.pontos == b.pontos && a.registro < b.registro);
+}
+
+static int compararEntradas(const void* a, const void* b) {
+    EntradaPlacar x = *(const EntradaPlacar*)a;
+    EntradaPlacar y = *(const EntradaPlacar*)b;
+    return antes(x, y) ? -1 : antes(y, x);
+}
+
+static EntradaPlacar entradaIndice(const Placar* placar, size_t i) {
+    const unsigned char* p = placar->indice + CABECALHO_INDICE + i * TAMANHO_ENTRADA;
+    EntradaPlacar entrada = {(int)ler32(p), ler32(p + 4)};
+    return entrada;
+}
+
+static int travar(int fd, int operacao) {
+    while (flock(fd, operacao) == -1) {
+        if (errno != EINTR)
+            return -1;
+    }
+    return 0;
+}
+
+static int lerTudo(int fd, unsigned char* buffer, size_t tamanho, off_t posicao) {
+    while (tamanho > 0) {
+        ssize_t n = pread(fd, buffer, tamanho, posicao);
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n <= 0)
+            return -1;
+        buffer += n;
+        tamanho -= (size_t)n;
+        posicao += n;
+    }
+    return 0;
+}
+
+static int escreverTudo(int fd, const unsigned char* buffer, size_t tamanho) {
+    while (tamanho > 0) {
+        ssize_t n = write(fd, buffer, tamanho);
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n <= 0)
+            return -1;
+        buffer += n;
+        tamanho -= (size_t)n;
+    }
+    return 0;
+}
+
+static off_t posicaoRegistro(uint64_t registro) {
+    return (off_t)(CABECALHO_LOG + registro * TAMANHO_REGISTRO);
+}
+
+static uint64_t registrosNoLog(int fd) {
+    struct stat info;
+    if (fstat(fd, &info) == -1 || info.st_size < CABECALHO_LOG)
+        return 0;
+    return (uint64_t)(info.st_size - CABECALHO_LOG) / TAMANHO_REGISTRO;
+}
+
+static void adicionarRecente(Placar* placar, EntradaPlacar entrada) {
+    if (placar->numRecentes == placar->capacidadeRecentes) {
+        size_t capacidade = placar->capacidadeRecentes ? placar->capacidadeRecentes * 2 : 64;
+        EntradaPlacar* novo = realloc(placar->recentes, capacidade * sizeof(EntradaPlacar));
+        if (novo == NULL) {
+            printf("Erro: Não foi possível alocar memória para o placar.\n");
+            exit(EXIT_FAILURE);
+        }
+        placar->recentes = novo;
+        placar->capacidadeRecentes = capacidade;
+    }
+    placar->recentes[placar->numRecentes++] = entrada;
+}
+
+// Traz para as recentes os registros acrescentados ao log desde a última leitura,
+// inclusive os de outros processos
+static int lerNovos(Placar* placar) {
+    if (travar(placar->fd, LOCK_SH) == -1)
+        return -1;
+    uint64_t total = registrosNoLog(placar->fd);
+    unsigned char* buffer = total > placar->lidos ? malloc(LOTE_LEITURA * TAMANHO_REGISTRO) : NULL;
+    size_t anteriores = placar->numRecentes;
+    int resultado = 0;
+
+    while (placar->lidos < total && resultado == 0) {
+        size_t n = total - placar->lidos < LOTE_LEITURA ? (size_t)(total - placar->lidos) : LOTE_LEITURA;
+        if (buffer == NULL || lerTudo(placar->fd, buffer, n * TAMANHO_REGISTRO, posicaoRegistro(placar->lidos)) == -1) {
+            resultado = -1;
+            break;
+        }
+        for (size_t i = 0; i < n; i++) {
+            Partida partida;
+            if (decodificarPartida(buffer + i * TAMANHO_REGISTRO, &partida) == -1) {
+                placar->corrompidos++;
+                continue;
+            }
+            EntradaPlacar entrada = {partida.pontos, (uint32_t)(placar->lidos + i)};
+            adicionarRecente(placar, entrada);
+        }
+        placar->lidos += n;
+    }
+    free(buffer);
+    travar(placar->fd, LOCK_UN);
+
+    // Uma partida nova entra no lugar certo; um lote grande é reordenado de uma vez
+    size_t novas = placar->numRecentes - anteriores;
+    if (novas == 1) {
+        EntradaPlacar entrada = placar->recentes[anteriores];
+        size_t i = anteriores;
+        while (i > 0 && antes(entrada, placar->recentes[i - 1])) {
+            placar->recentes[i] = placar->recentes[i - 1];
+            i--;
+        }
+        placar->recentes[i] = entrada;
+    } else if (novas > 1) {
+        qsort(placar->recentes, placar->numRecentes, sizeof(EntradaPlacar), compararEntradas);
+    }
+    return resultado;
+}
+
+// Cria o cabeçalho de um log vazio ou confere o de um existente e corta o fim rasgado
+// por uma queda: só registros inteiros e com a soma certa ficam no fim do log
+static int repararLog(int fd, const char* caminho) {
+    struct stat info;
+    if (fstat(fd, &info) == -1) {
+        perror(caminho);
+        return -1;
+    }
+    unsigned char cabecalho[CABECALHO_LOG];
+    if (info.st_size == 0) {
+        memcpy(cabecalho, MAGICO_LOG, 4);
+        escrever32(cabecalho + 4, TAMANHO_REGISTRO);
+        if (escreverTudo(fd, cabecalho, CABECALHO_LOG) == -1 || fdatasync(fd) == -1) {
+            perror(caminho);
+            return -1;
+        }
+        return 0;
+    }
+    if (info.st_size < CABECALHO_LOG || lerTudo(fd, cabecalho, CABECALHO_LOG, 0) == -1 ||
+        memcmp(cabecalho, MAGICO_LOG, 4) != 0 || ler32(cabecalho + 4) != TAMANHO_REGISTRO) {
+        fprintf(stderr, "%s: não é um arquivo de placar\n", caminho);
+        return -1;
+    }
+
+    uint64_t registros = (uint64_t)(info.st_size - CABECALHO_LOG) / TAMANHO_REGISTRO;
+    unsigned char registro[TAMANHO_REGISTRO];
+    Partida partida;
+    while (registros > 0 &&
+           (lerTudo(fd, registro, TAMANHO_REGISTRO, posicaoRegistro(registros - 1)) == -1 ||
+            decodificarPartida(registro, &partida) == -1))
+        registros--;
+    if (posicaoRegistro(registros) != info.st_size) {
+        if (ftruncate(fd, posicaoRegistro(registros)) == -1 || fdatasync(fd) == -1) {
+            perror(caminho);
+            return -1;
+        }
+    }
+    return 0;
+}
+
+static uint32_t somaRegistro(int fd, uint64_t registro) {
+    unsigned char p[TAMANHO_REGISTRO];
+    if (lerTudo(fd, p, TAMANHO_REGISTRO, posicaoRegistro(registro)) == -1)
+        return 0;
+    return ler32(p + 28);
+}
+
+static void descartarIndice(Placar* placar) {
+    if (placar->indice != NULL)
+        munmap(placar->indice, placar->tamanhoIndice);
+    placar->indice = NULL;
+    placar->tamanhoIndice = 0;
+    placar->numIndice = 0;
+    placar->cobertos = 0;
+}
+
+// Mapeia o índice se ele for íntegro e ainda descrever o começo deste log;
+// senão o placar começa sem índice e o log inteiro vira partidas recentes
+static void carregarIndice(Placar* placar) {
+    int fd = open(placar->caminhoIndice, O_RDONLY | O_CLOEXEC);
+    if (fd == -1)
+        return;
+    struct stat info;
+    if (fstat(fd, &info) == -1 || info.st_size < CABECALHO_INDICE) {
+        close(fd);
+        return;
+    }
+    placar->tamanhoIndice = (size_t)info.st_size;
+    placar->indice = mmap(NULL, placar->tamanhoIndice, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (placar->indice == MAP_FAILED) {
+        placar->indice = NULL;
+        return;
+    }
+
+    const unsigned char* p = placar->indice;
+    placar->numIndice = ler32(p + 4);
+    placar->cobertos = ler64(p + 8);
+    int valido = memcmp(p, MAGICO_INDICE, 4) == 0 && ler32(p + 28) == fnv1a(FNV1A_INICIAL, p, 28) &&
+                 placar->tamanhoIndice == CABECALHO_INDICE + placar->numIndice * TAMANHO_ENTRADA &&
+                 placar->cobertos <= registrosNoLog(placar->fd) &&
+                 (placar->cobertos == 0 || somaRegistro(placar->fd, placar->cobertos - 1) == ler32(p + 16));
+    if (!valido) {
+        descartarIndice(placar);
+        return;
+    }
+    placar->corrompidos = ler32(p + 20);
+    madvise(placar->indice, placar->tamanhoIndice, MADV_RANDOM);
+}
+
+int abrirPlacar(Placar* placar, const char* caminho) {
+    memset(placar, 0, sizeof(*placar));
+    placar->fd = open(caminho, O_RDWR | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+    if (placar->fd == -1) {
+        perror(caminho);
+        return -1;
+    }
+    if (travar(placar->fd, LOCK_EX) == -1 || repararLog(placar->fd, caminho) == -1) {
+        close(placar->fd);
+        return -1;
+    }
+    travar(placar->fd, LOCK_UN);
+
+    placar->caminhoIndice = malloc(strlen(caminho) + sizeof(".idx"));
+    if (placar->caminhoIndice == NULL) {
+        close(placar->fd);
+        return -1;
+    }
+    sprintf(placar->caminhoIndice, "%s.idx", caminho);
+    carregarIndice(placar);
+    placar->lidos = placar->cobertos;
+
+    if (lerNovos(placar) == -1) {
+        fprintf(stderr, "%s: erro ao ler o log do placar\n", caminho);
+        fecharPlacar(placar);
+        return -1;
+    }
+    // Sem índice (ou com um velho demais) o próximo abrir não deve varrer tudo de novo
+    if (placar->numRecentes > LIMITE_RECENTES && compactarPlacar(placar) == -1)
+        fprintf(stderr, "%s: não foi possível regravar o índice\n", placar->caminhoIndice);
+    return 0;
+}
+
+void fecharPlacar(Placar* placar) {
+    descartarIndice(placar);
+    if (placar->fd != -1)
+        close(placar->fd);
+    free(placar->caminhoIndice);
+    free(placar->recentes);
+    placar->fd = -1;
+    placar->caminhoIndice = NULL;
+    placar->recentes = NULL;
+    placar->numRecentes = 0;
+    placar->capacidadeRecentes = 0;
+}
+
+int registrarPartidas(Placar* placar, const Partida* partidas, size_t n) {
+    if (n == 0)
+        return 0;
+    unsigned char* buffer = malloc(n * TAMANHO_REGISTRO);
+    if (buffer == NULL)
+        return -1;
+    for (size_t i = 0; i < n; i++)
+        codificarPartida(buffer + i * TAMANHO_REGISTRO, &partidas[i]);
+
+    // O_APPEND põe cada lote inteiro no fim mesmo com outros processos gravando;
+    // a trava só impede que alguém leia ou repare o log no meio da escrita
+    int resultado = -1;
+    if (travar(placar->fd, LOCK_EX) == 0) {
+        if (escreverTudo(placar->fd, buffer, n * TAMANHO_REGISTRO) == 0 && fdatasync(placar->fd) == 0)
+            resultado = 0;
+        travar(placar->fd, LOCK_UN);
+    }
+    free(buffer);
+    if (resultado == -1 || lerNovos(placar) == -1)
+        return -1;
+    if (placar->numRecentes > LIMITE_RECENTES)
+        return compactarPlacar(placar);
+    return 0;
+}
+
+int registrarPartida(Placar* placar, const Partida* partida) {
+    return registrarPartidas(placar, partida, 1);
+}
+
+int compactarPlacar(Placar* placar) {
+    if (lerNovos(placar) == -1)
+        return -1;
+    size_t total = placar->numIndice + placar->numRecentes;
+    size_t tamanho = CABECALHO_INDICE + total * TAMANHO_ENTRADA;
+    unsigned char* buffer = malloc(tamanho);
+    if (buffer == NULL)
+        return -1;
+
+    // Intercala o índice e as recentes, as duas já ordenadas
+    size_t i = 0, j = 0;
+    for (size_t k = 0; k < total; k++) {
+        EntradaPlacar entrada;
+        if (j == placar->numRecentes || (i < placar->numIndice && antes(entradaIndice(placar, i), placar->recentes[j])))
+            entrada = entradaIndice(placar, i++);
+        else
+            entrada = placar->recentes[j++];
+        unsigned char* p = buffer + CABECALHO_INDICE + k * TAMANHO_ENTRADA;
+        escrever32(p, (uint32_t)entrada.pontos);
+        escrever32(p + 4, entrada.registro);
+    }
+    memcpy(buffer, MAGICO_INDICE, 4);
+    escrever32(buffer + 4, (uint32_t)total);
+    escrever64(buffer + 8, placar->lidos);
+    escrever32(buffer + 16, placar->lidos > 0 ? somaRegistro(placar->fd, placar->lidos - 1) : 0);
+    escrever32(buffer + 20, (uint32_t)placar->corrompidos);
+    memset(buffer + 24, 0, 4);
+    escrever32(buffer + 28, fnv1a(FNV1A_INICIAL, buffer, 28));
+
+    // Temporário por processo e rename: quem abrir no meio vê o índice velho ou o novo inteiro
+    char temporario[4096];
+    snprintf(temporario, sizeof(temporario), "%s.%ld.tmp", placar->caminhoIndice, (long)getpid());
+    int fd = open(temporario, O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    int ok = fd != -1 && escreverTudo(fd, buffer, tamanho) == 0 && fsync(fd) == 0;
+    free(buffer);
+    unsigned char* novo = ok ? mmap(NULL, tamanho, PROT_READ, MAP_SHARED, fd, 0) : MAP_FAILED;
+    if (fd != -1)
+        close(fd);
+    if (novo == MAP_FAILED || rename(temporario, placar->caminhoIndice) != 0) {
+        if (novo != MAP_FAILED)
+            munmap(novo, tamanho);
+        unlink(temporario);
+        return -1;
+    }
+
+    uint64_t lidos = placar->lidos;
+    descartarIndice(placar);
+    placar->indice = novo;
+    placar->tamanhoIndice = tamanho;
+    placar->numIndice = total;
+    placar->cobertos = lidos;
+    placar->numRecentes = 0;
+    madvise(placar->indice, placar->tamanhoIndice, MADV_RANDOM);
+    return 0;
+}
+
+size_t totalPartidas(const Placar* placar) {
+    return placar->numIndice + placar->numRecentes;
+}
+
+size_t melhoresPartidas(const Placar* placar, size_t k, Partida* saida) {
+    size_t i = 0, j = 0, n = 0;
+    while (n < k && (i < placar->numIndice || j < placar->numRecentes)) {
+        EntradaPlacar entrada;
+        if (j == placar->numRecentes || (i < placar->numIndice && antes(entradaIndice(placar, i), placar->recentes[j])))
+            entrada = entradaIndice(placar, i++);
+        else
+            entrada = placar->recentes[j++];
+        unsigned char registro[TAMANHO_REGISTRO];
+        if (lerTudo(placar->fd, registro, TAMANHO_REGISTRO, posicaoRegistro(entrada.registro)) == 0 &&
+            decodificarPartida(registro, &saida[n]) == 0)
+            n++;
+    }
+    return n;
+}
+
+// Quantas entradas de um trecho ordenado têm pelo menos "pontos": busca binária
+static size_t contarAoMenos(const Placar* placar, const EntradaPlacar* recentes, size_t n, int pontos) {
+    size_t baixo = 0, alto = n;
+    while (baixo < alto) {
+        size_t meio = baixo + (alto - baixo) / 2;
+        int p = recentes != NULL ? recentes[meio].pontos : entradaIndice(placar, meio).pontos;
+        if (p >= pontos)
+            baixo = meio + 1;
+        else
+            alto = meio;
+    }
+    return baixo;
+}
+
+double percentilPontos(const Placar* placar, int pontos) {
+    size_t total = totalPartidas(placar);
+    if (total == 0)
+        return 0.0;
+    size_t acima = contarAoMenos(placar, NULL, placar->numIndice, pontos) +
+                   contarAoMenos(placar, placar->recentes, placar->numRecentes, pontos);
+    return (double)(total - acima) / (double)total;
+}
+
+// k-ésima entrada (a partir de 0) da união do índice com as recentes, em O(log n):
+// procura quantas das k + 1 primeiras vêm do índice
+static EntradaPlacar kEsima(const Placar* placar, size_t k) {
+    size_t n = placar->numIndice, m = placar->numRecentes;
+    size_t baixo = k + 1 > m ? k + 1 - m : 0;
+    size_t alto = k + 1 < n ? k + 1 : n;
+    while (baixo < alto) {
+        size_t i = baixo + (alto - baixo) / 2;
+        size_t j = k + 1 - i;
+        if (j > 0 && antes(entradaIndice(placar, i), placar->recentes[j - 1]))
+            baixo = i + 1;
+        else
+            alto = i;
+    }
+    size_t i = baixo, j = k + 1 - baixo;
+    if (i == 0)
+        return placar->recentes[j - 1];
+    if (j == 0)
+        return entradaIndice(placar, i - 1);
+    EntradaPlacar a = entradaIndice(placar, i - 1), b = placar->recentes[j - 1];
+    return antes(a, b) ? b : a;
+}
+
+int pontosNoPercentil(const Placar* placar, double p) {
+    size_t total = totalPartidas(placar);
+    if (total == 0)
+        return 0;
+    if (p < 0.0)
+        p = 0.0;
+    if (p > 1.0)
+        p = 1.0;
+    size_t deBaixo = (size_t)(p * (double)(total - 1) + 0.5);
+    return kEsima(placar, total - 1 - deBaixo).pontos;
+}
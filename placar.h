@@ -0,0 +1,66 @@
+#ifndef PLACAR_H
+#define PLACAR_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Placar local: um log de partidas que só cresce e um índice ordenado por pontos.
+// Cada partida é gravada com um único write e fdatasync; um registro rasgado por
+// queda do processo ou da máquina é detectado pela soma e descartado ao abrir.
+// O índice fica ao lado do log (<caminho>.idx), é mapeado com mmap e só é
+// reescrito (temporário + rename) quando acumulam partidas recentes demais.
+// O índice é derivado do log: se sumir ou não bater com ele, é reconstruído.
+
+typedef struct {
+    int pontos;
+    uint32_t comprimento; // Segmentos da cobrinha no fim da partida
+    uint64_t duracao;     // Microssegundos de jogo (relógio virtual do motor)
+    uint64_t replay;      // Semente da partida: com o mapa, identifica o replay
+    uint32_t mapa;        // Impressão digital do mapa
+} Partida;
+
+typedef struct {
+    int pontos;
+    uint32_t registro; // Posição da partida no log
+} EntradaPlacar;
+
+typedef struct {
+    int fd;                  // Log de partidas, aberto com O_APPEND
+    char* caminhoIndice;
+    unsigned char* indice;   // Índice mapeado: cabeçalho e entradas ordenadas
+    size_t tamanhoIndice;
+    size_t numIndice;
+    uint64_t cobertos;       // Registros do log que já estão no índice
+    uint64_t lidos;          // Registros do log já vistos (índice + recentes)
+    EntradaPlacar* recentes; // Partidas depois do índice, ordenadas como ele
+    size_t numRecentes;
+    size_t capacidadeRecentes;
+    uint64_t corrompidos;    // Registros com soma errada no meio do log, ignorados
+} Placar;
+
+// Abre ou cria o placar; devolve -1 e escreve o motivo em stderr se falhar
+int abrirPlacar(Placar* placar, const char* caminho);
+
+void fecharPlacar(Placar* placar);
+
+// Acrescenta partidas ao log numa escrita só, com um fdatasync no fim
+int registrarPartidas(Placar* placar, const Partida* partidas, size_t n);
+
+int registrarPartida(Placar* placar, const Partida* partida);
+
+// Junta as partidas recentes ao índice e o regrava
+int compactarPlacar(Placar* placar);
+
+size_t totalPartidas(const Placar* placar);
+
+// As k melhores partidas, da maior pontuação para a menor (empate: a mais antiga
+// primeiro); devolve quantas foram escritas em saida
+size_t melhoresPartidas(const Placar* placar, size_t k, Partida* saida);
+
+// Fração (0 a 1) das partidas com pontuação abaixo de pontos
+double percentilPontos(const Placar* placar, int pontos);
+
+// Pontuação abaixo da qual está a fração p (0 a 1) das partidas; 0 sem partidas
+int pontosNoPercentil(const Placar* placar, double p);
+
+#endif
@@ -0,0 +1,291 @@
+#include "snapshot.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "binario.h"
+
+// Layout do cabeçalho (inteiros em little-endian):
+//   0 "COB" + versão   4 direção   6 comidaX   8 comidaY   10 cabeçaX   12 cabeçaY
+//   16 pontos   20 comprimento   24 decorrido   32 semente   40 id do mapa
+// Depois vêm os passos de 2 bits e, no fim, o FNV-1a de 32 bits de tudo o que veio antes.
+// Um segmento numa ponta de portal chegou pela outra ponta, então o passo até o
+// segmento seguinte sai da outra ponta; o contorno das bordas vale como no jogo.
+static const unsigned char MAGICO[4] = {'C', 'O', 'B', 2};
+#define SEM_COMIDA_16 0xFFFF
+
+static const int PASSO_DX[4] = {0, 0, -1, 1}; // Mesma ordem de CIMA, BAIXO, ESQUERDA, DIREITA
+static const int PASSO_DY[4] = {-1, 1, 0, 0};
+
+static size_t tamanhoPorComprimento(uint32_t comprimento) {
+    return CABECALHO_SNAPSHOT + (comprimento + 2) / 4 + 4; // (comprimento - 1) passos, arredondado
+}
+
+// Vizinho de (x, y) no sentido do código, dando a volta se o mapa tiver contorno
+static int vizinho(const Mapa* mapa, int x, int y, int codigo, int* vx, int* vy) {
+    x += PASSO_DX[codigo];
+    y += PASSO_DY[codigo];
+    if ((unsigned)x >= (unsigned)mapa->largura || (unsigned)y >= (unsigned)mapa->altura) {
+        if (!mapa->contorno)
+            return -1;
+        x = (x + mapa->largura) % mapa->largura;
+        y = (y + mapa->altura) % mapa->altura;
+    }
+    *vx = x;
+    *vy = y;
+    return 0;
+}
+
+// Célula de onde sai o passo para o segmento seguinte (a outra ponta, se for portal)
+static int origemPasso(const Mapa* mapa, int* x, int* y) {
+    int i = *y * mapa->largura + *x;
+    if (tipoCelula(mapa, i) == CELULA_PORTAL) {
+        i = destinoPortal(mapa, i);
+        *x = i % mapa->largura;
+        *y = i / mapa->largura;
+    }
+    return i;
+}
+
+static int codigoPasso(const Mapa* mapa, const Node* de, const Node* para) {
+    int x = de->x, y = de->y, vx, vy;
+    origemPasso(mapa, &x, &y);
+    for (int c = 0; c < 4; c++)
+        if (vizinho(mapa, x, y, c, &vx, &vy) == 0 && vx == para->x && vy == para->y)
+            return c;
+    return -1;
+}
+
+size_t tamanhoSnapshot(const Jogo* jogo) {
+    uint32_t comprimento = 0;
+    for (Node* atual = jogo->cobrinha.cabeca; atual != NULL; atual = atual->prox)
+        comprimento++;
+    return tamanhoPorComprimento(comprimento);
+}
+
+size_t salvarJogo(const Jogo* jogo, void* buffer, size_t tamanho) {
+    unsigned char* p = (unsigned char*)buffer;
+    const Node* cabeca = jogo->cobrinha.cabeca;
+    if (cabeca == NULL || tamanho < tamanhoPorComprimento(1))
+        return 0;
+
+    // Os passos são escritos enquanto a lista é percorrida; o comprimento só se sabe no
+    // fim, então cada byte é zerado ao receber seu primeiro passo, não o buffer inteiro
+    uint32_t comprimento = 1;
+    for (const Node* atual = cabeca; atual->prox != NULL; atual = atual->prox) {
+        if (tamanhoPorComprimento(comprimento + 1) > tamanho)
+            return 0;
+        int codigo = codigoPasso(jogo->mapa, atual, atual->prox);
+        if (codigo < 0)
+            return 0;
+        size_t i = comprimento - 1;
+        if (i % 4 == 0)
+            p[CABECALHO_SNAPSHOT + i / 4] = 0;
+        p[CABECALHO_SNAPSHOT + i / 4] |= (unsigned char)(codigo << (2 * (i % 4)));
+        comprimento++;
+    }
+
+    memcpy(p, MAGICO, sizeof(MAGICO));
+    p[4] = (unsigned char)jogo->direcao;
+    p[5] = 0;
+    escrever16(p + 6, jogo->comidaX == SEM_COMIDA ? SEM_COMIDA_16 : (uint16_t)jogo->comidaX);
+    escrever16(p + 8, jogo->comidaY == SEM_COMIDA ? SEM_COMIDA_16 : (uint16_t)jogo->comidaY);
+    escrever16(p + 10, (uint16_t)cabeca->x);
+    escrever16(p + 12, (uint16_t)cabeca->y);
+    escrever16(p + 14, 0);
+    escrever32(p + 16, (uint32_t)jogo->pontos);
+    escrever32(p + 20, comprimento);
+    escrever64(p + 24, jogo->decorrido);
+    escrever64(p + 32, jogo->semente);
+    escrever32(p + 40, jogo->mapa->id);
+
+    size_t usados = tamanhoPorComprimento(comprimento);
+    escrever32(p + usados - 4, fnv1a(FNV1A_INICIAL, p, usados - 4));
+    return usados;
+}
+
+// Confere cabeçalho, tamanho e soma; devolve o comprimento ou 0 se o snapshot for inválido
+static uint32_t validarSnapshot(const Mapa* mapa, const unsigned char* p, size_t tamanho) {
+    if (tamanho < tamanhoPorComprimento(1) || memcmp(p, MAGICO, sizeof(MAGICO)) != 0)
+        return 0;
+
+    uint32_t comprimento = ler32(p + 20);
+    if (comprimento == 0 || comprimento > (uint32_t)(mapa->largura * mapa->altura) ||
+        tamanho != tamanhoPorComprimento(comprimento))
+        return 0;
+    if (ler32(p + tamanho - 4) != fnv1a(FNV1A_INICIAL, p, tamanho - 4) || ler32(p + 40) != mapa->id)
+        return 0;
+
+    // Pontos negativos quebrariam quem indexa por eles, como atrasoPasso
+    if (ler32(p + 16) > INT32_MAX)
+        return 0;
+
+    char direcao = (char)p[4];
+    int comidaX = ler16(p + 6), comidaY = ler16(p + 8);
+    int x = ler16(p + 10), y = ler16(p + 12);
+    if (comidaX != SEM_COMIDA_16 && comidaY != SEM_COMIDA_16 &&
+        (comidaX >= mapa->largura || comidaY >= mapa->altura ||
+         tipoCelula(mapa, comidaY * mapa->largura + comidaX) == CELULA_PAREDE))
+        return 0;
+    if ((direcao != CIMA && direcao != BAIXO && direcao != ESQUERDA && direcao != DIREITA) ||
+        x >= mapa->largura || y >= mapa->altura || tipoCelula(mapa, y * mapa->largura + x) == CELULA_PAREDE)
+        return 0;
+    return comprimento;
+}
+
+// Copia o estado e monta o corpo numa partida sem cobrinha; devolve -1 se um passo
+// cair em parede ou no próprio corpo, deixando montado o que já deu certo
+static int montarPartida(Jogo* jogo, const unsigned char* p, uint32_t comprimento) {
+    const Mapa* mapa = jogo->mapa;
+    int comidaX = ler16(p + 6), comidaY = ler16(p + 8);
+    int x = ler16(p + 10), y = ler16(p + 12);
+    jogo->direcao = (char)p[4];
+    if (comidaX == SEM_COMIDA_16 || comidaY == SEM_COMIDA_16)
+        comidaX = comidaY = SEM_COMIDA;
+    jogo->comidaX = comidaX;
+    jogo->comidaY = comidaY;
+    jogo->pontos = (int)ler32(p + 16);
+    jogo->decorrido = ler64(p + 24);
+    jogo->semente = ler64(p + 32);
+
+    anexarSegmento(jogo, x, y);
+    for (uint32_t i = 0; i + 1 < comprimento; i++) {
+        int codigo = (p[CABECALHO_SNAPSHOT + i / 4] >> (2 * (i % 4))) & 3;
+        origemPasso(mapa, &x, &y);
+        if (vizinho(mapa, x, y, codigo, &x, &y) == -1 ||
+            tipoCelula(mapa, y * mapa->largura + x) == CELULA_PAREDE ||
+            bitLigado(jogo->ocupacao, y * mapa->largura + x))
+            return -1;
+        anexarSegmento(jogo, x, y);
+    }
+    return 0;
+}
+
+int restaurarJogo(Jogo* jogo, const Mapa* mapa, const void* buffer, size_t tamanho) {
+    uint32_t comprimento = validarSnapshot(mapa, buffer, tamanho);
+    if (comprimento == 0)
+        return -1;
+
+    // Só as alocações, sem cobrinha inicial nem sorteio de comida para desfazer
+    prepararJogo(jogo, mapa);
+    if (montarPartida(jogo, buffer, comprimento) == -1) {
+        finalizarJogo(jogo);
+        return -1;
+    }
+    return 0;
+}
+
+int restaurarSobreJogo(Jogo* jogo, const void* buffer, size_t tamanho) {
+    uint32_t comprimento = validarSnapshot(jogo->mapa, buffer, tamanho);
+    if (comprimento == 0)
+        return -1;
+
+    esvaziarCobrinha(jogo);
+    if (montarPartida(jogo, buffer, comprimento) == -1) {
+        reiniciarJogo(jogo, jogo->semente);
+        return -1;
+    }
+    return 0;
+}
+
+int gravarSnapshot(const Jogo* jogo, const char* caminho) {
+    size_t tamanho = tamanhoSnapshot(jogo);
+    unsigned char* buffer = malloc(tamanho);
+    if (buffer == NULL)
+        return -1;
+    size_t usados = salvarJogo(jogo, buffer, tamanho);
+
+    // Grava num temporário, leva ao disco e renomeia, para nunca deixar um snapshot
+    // pela metade, nem um rename que chegue ao disco antes dos dados
+    char temporario[4096];
+    snprintf(temporario, sizeof(temporario), "%s.tmp", caminho);
+    FILE* arquivo = fopen(temporario, "wb");
+    int ok = usados > 0 && arquivo != NULL && fwrite(buffer, 1, usados, arquivo) == usados &&
+             fflush(arquivo) == 0 && fsync(fileno(arquivo)) == 0;
+    if (arquivo != NULL && fclose(arquivo) != 0)
+        ok = 0;
+    free(buffer);
+    if (!ok || rename(temporario, caminho) != 0) {
+        unlink(temporario);
+        return -1;
+    }
+    return 0;
+}
+
+int lerSnapshot(Jogo* jogo, const Mapa* mapa, const char* caminho) {
+    FILE* arquivo = fopen(caminho, "rb");
+    if (arquivo == NULL)
+        return -1;
+
+    // O buffer tem o tamanho do arquivo; maior que o de uma cobrinha no mapa inteiro nem é lido
+    struct stat info;
+    size_t maximo = tamanhoPorComprimento((uint32_t)(mapa->largura * mapa->altura));
+    if (fstat(fileno(arquivo), &info) == -1 || info.st_size <= 0 || (uint64_t)info.st_size > maximo) {
+        fclose(arquivo);
+        return -1;
+    }
+    size_t tamanho = (size_t)info.st_size;
+    unsigned char* buffer = malloc(tamanho);
+    size_t lidos = buffer != NULL ? fread(buffer, 1, tamanho, arquivo) : 0;
+    fclose(arquivo);
+    int resultado = lidos == tamanho ? restaurarJogo(jogo, mapa, buffer, lidos) : -1;
+    free(buffer);
+    return resultado;
+}
+
+int ramificarJogo(const Jogo* jogo, int ramos, int paralelos, AvaliarRamo avaliar, void* contexto, int64_t* notas) {
+    if (ramos <= 0)
+        return 0;
+    if (paralelos <= 0)
+        paralelos = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    if (paralelos > ramos)
+        paralelos = ramos;
+
+    // Os filhos devolvem as notas numa área compartilhada, uma posição por ramo
+    size_t bytes = (size_t)ramos * sizeof(int64_t);
+    int64_t* compartilhadas = mmap(NULL, bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    pid_t* filhos = malloc((size_t)paralelos * sizeof(pid_t));
+    if (compartilhadas == MAP_FAILED || filhos == NULL) {
+        if (compartilhadas != MAP_FAILED)
+            munmap(compartilhadas, bytes);
+        free(filhos);
+        return -1;
+    }
+
+    // Espera os filhos na ordem em que nasceram, para não colher filhos de outros módulos
+    int falhas = 0, criados = 0, colhidos = 0;
+    for (int ramo = 0; ramo < ramos; ramo++) {
+        if (criados - colhidos == paralelos) {
+            int status;
+            if (waitpid(filhos[colhidos++ % paralelos], &status, 0) == -1 || !WIFEXITED(status) || WEXITSTATUS(status) != 0)
+                falhas++;
+        }
+
+        pid_t pid = fork();
+        if (pid < 0) {
+            perror("fork");
+            falhas += ramos - ramo;
+            break;
+        } else if (pid == 0) { // Processo filho: a partida e a lista são as do pai, em copy-on-write
+            Jogo copia = *jogo;
+            compartilhadas[ramo] = avaliar(&copia, ramo, contexto);
+            _exit(EXIT_SUCCESS);
+        }
+        filhos[criados++ % paralelos] = pid;
+    }
+    while (colhidos < criados) {
+        int status;
+        if (waitpid(filhos[colhidos++ % paralelos], &status, 0) == -1 || !WIFEXITED(status) || WEXITSTATUS(status) != 0)
+            falhas++;
+    }
+
+    memcpy(notas, compartilhadas, bytes);
+    munmap(compartilhadas, bytes);
+    free(filhos);
+    return falhas == 0 ? 0 : -1;
+}
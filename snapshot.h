@@ -0,0 +1,42 @@
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "jogo.h"
+
+// Snapshot binário de uma partida: cabeçalho fixo, posição da cabeça e cada
+// segmento seguinte como um passo de 2 bits (cima, baixo, esquerda, direita).
+// O mapa não é salvo, só sua impressão digital, e a partida só volta no mesmo mapa.
+#define CABECALHO_SNAPSHOT 44
+
+// Bytes necessários para o snapshot da partida (percorre a cobrinha uma vez)
+size_t tamanhoSnapshot(const Jogo* jogo);
+
+// Serializa a partida em buffer; devolve os bytes escritos ou 0 se não couber
+size_t salvarJogo(const Jogo* jogo, void* buffer, size_t tamanho);
+
+// Reconstrói a partida no mapa a partir de um snapshot; devolve -1 se estiver
+// corrompido ou for de outro mapa. jogo não precisa estar inicializado e deve
+// ser liberado com finalizarJogo.
+int restaurarJogo(Jogo* jogo, const Mapa* mapa, const void* buffer, size_t tamanho);
+
+// Restaura por cima de uma partida já inicializada no mesmo mapa, reaproveitando
+// as alocações: custa O(comprimento) como reiniciarJogo, não O(tamanho do mapa).
+// Devolve -1 sem mexer na partida se o snapshot for inválido; se o corpo só se
+// mostrar inválido no meio da montagem, a partida volta a ser uma partida nova.
+int restaurarSobreJogo(Jogo* jogo, const void* buffer, size_t tamanho);
+
+int gravarSnapshot(const Jogo* jogo, const char* caminho);
+int lerSnapshot(Jogo* jogo, const Mapa* mapa, const char* caminho);
+
+// Avalia uma cópia da partida e devolve uma nota; pode modificar a cópia à vontade
+typedef int64_t (*AvaliarRamo)(Jogo* copia, int ramo, void* contexto);
+
+// Avalia "ramos" cópias da partida, cada uma num processo filho criado com fork(),
+// que herda a partida por copy-on-write sem copiar a lista. No máximo "paralelos"
+// filhos rodam ao mesmo tempo (0 usa o número de CPUs). Devolve -1 se algum ramo falhar.
+int ramificarJogo(const Jogo* jogo, int ramos, int paralelos, AvaliarRamo avaliar, void* contexto, int64_t* notas);
+
+#endif
@@ -0,0 +1,436 @@
+// Soak sem tela: joga partidas aleatórias por um tempo fixo (ou um número de
+// partidas), mede a latência de cada passo e a memória residente ao longo do
+// tempo, e compara com uma linha de base gravada. O digitador desvia de passos
+// fatais, para que as partidas comam, cresçam e andem pelo mapa inteiro.
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "entrada.h"
+#include "jogo.h"
+#include "medidas.h"
+#include "sorteio.h"
+
+#define DURACAO_PADRAO 30.0     // Segundos de soak quando o número de partidas não é dado
+#define INTERVALO_AMOSTRA 1.0   // Segundos entre duas amostras de memória
+#define LIMITE_PASSOS 100000    // Uma partida que passe disso é encerrada
+#define CRESCIMENTO_RSS 4096    // KB que a memória pode crescer depois da primeira amostra
+#define TOLERANCIA_PADRAO 0.2   // Contra uma linha de base que é a pior de cinco rodadas
+
+// A quarentena do ASan faz a memória crescer sem vazamento; lá quem acusa vazamento é o LSan
+#if defined(__SANITIZE_ADDRESS__)
+#define SANITIZER_DE_ENDERECO 1
+#else
+#define SANITIZER_DE_ENDERECO 0
+#endif
+
+static const char TECLAS[] = {CIMA, BAIXO, ESQUERDA, DIREITA};
+
+typedef struct {
+    int indice;
+    long jogos;         // Partidas a jogar; 0 joga até o fim da duração
+    long feitos;
+    uint64_t semente;
+    const char* backend;
+    const Mapa* mapa;
+    int semTela;        // Só o motor: não monta nem renderiza a tela a cada passo
+    double intervaloAmostra;
+    Histograma latencias;
+    long long passos;
+    long long pontos;
+    long long portais;  // Passos em que a cabeça entrou num portal
+    long long bordas;   // Passos em que a cabeça atravessou a borda de um mapa com contorno
+    long rssInicial;
+    long rssMaximo;
+    int erro;
+} Trabalhador;
+
+typedef struct {
+    int fd;
+    uint64_t semente;
+    atomic_int parar;
+} Digitador;
+
+typedef struct {
+    double passosPorSegundo;
+    double p99;
+    double p999;
+} LinhaBase;
+
+static unsigned long long inicio;
+static unsigned long long fim; // Instante de parar quando o soak é por duração
+
+// Gerador das teclas, separado do gerador de comida do jogo
+static uint32_t sortearTecla(uint64_t* estado) {
+    return xorshift64Estrela(estado);
+}
+
+// Thread que escreve teclas aleatórias no pipe do backend até mandarem parar
+static void* digitarAleatorio(void* arg) {
+    Digitador* digitador = (Digitador*)arg;
+    struct timespec pausa = {0, 10000};
+    while (!atomic_load(&digitador->parar)) {
+        char tecla = TECLAS[sortearTecla(&digitador->semente) % sizeof(TECLAS)];
+        if (write(digitador->fd, &tecla, sizeof(char)) != 1 && errno != EAGAIN)
+            break;
+        nanosleep(&pausa, NULL);
+    }
+    return NULL;
+}
+
+// Se a frente bater no próximo passo, vira para uma direção que sobreviva, se houver.
+// Sem isso metade das teclas aleatórias (as meias-voltas) mata a cobrinha na hora
+// e quase nenhuma partida come, cresce ou sai de perto do nascimento.
+static void desviar(Jogo* jogo, uint64_t* estado) {
+    if (direcaoSegura(jogo, jogo->direcao))
+        return;
+    int primeira = (int)(sortearTecla(estado) % sizeof(TECLAS));
+    for (int k = 0; k < (int)sizeof(TECLAS); k++) {
+        char tecla = TECLAS[(primeira + k) % sizeof(TECLAS)];
+        if (direcaoSegura(jogo, tecla)) {
+            mudarDirecao(jogo, tecla);
+            return;
+        }
+    }
+}
+
+// Classifica o passo que levou a cabeça de (x, y) para a cabeça atual: um salto
+// que não é para a vizinha é portal, a menos que a vizinha esteja fora do mapa
+static void contarTravessia(Trabalhador* t, const Jogo* jogo, int x, int y, char direcao) {
+    const Node* cabeca = jogo->cobrinha.cabeca;
+    if (abs(cabeca->x - x) + abs(cabeca->y - y) == 1)
+        return;
+    int vx = x + (direcao == DIREITA) - (direcao == ESQUERDA);
+    int vy = y + (direcao == BAIXO) - (direcao == CIMA);
+    if ((unsigned)vx >= (unsigned)jogo->mapa->largura || (unsigned)vy >= (unsigned)jogo->mapa->altura)
+        t->bordas++;
+    else
+        t->portais++;
+}
+
+static void amostrarMemoria(Trabalhador* t, long jogos) {
+    long rss = memoriaResidente();
+    double segundos = (agora() - inicio) / 1e9;
+    if (t->rssInicial == 0)
+        t->rssInicial = rss;
+    if (rss > t->rssMaximo)
+        t->rssMaximo = rss;
+    printf("amostra: %.1f s, %ld jogos, %.0f passos/s, rss %ld KB\n",
+           segundos, jogos, t->passos / segundos, rss);
+    fflush(stdout);
+}
+
+static void* trabalhar(void* arg) {
+    Trabalhador* t = (Trabalhador*)arg;
+    uint64_t estado = t->semente * 2 + 1;
+    char* quadro = malloc(tamanhoQuadro(t->mapa));
+    if (quadro == NULL) {
+        t->erro = 1;
+        return NULL;
+    }
+
+    Entrada entrada;
+    Digitador digitador = {-1, t->semente + 1, 0};
+    pthread_t thread;
+    int fonte[2] = {-1, -1};
+
+    if (t->backend != NULL) {
+        if (pipe(fonte) == -1) {
+            perror("pipe");
+            t->erro = 1;
+            return NULL;
+        }
+        fcntl(fonte[1], F_SETFL, fcntl(fonte[1], F_GETFL, 0) | O_NONBLOCK);
+        if (criarEntrada(&entrada, t->backend, fonte[0]) == -1) {
+            fprintf(stderr, "Erro ao iniciar o backend '%s'.\n", t->backend);
+            t->erro = 1;
+            return NULL;
+        }
+        digitador.fd = fonte[1];
+        if (pthread_create(&thread, NULL, digitarAleatorio, &digitador) != 0) {
+            printf("Erro ao criar thread do digitador.\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    Jogo jogo;
+    inicializarJogo(&jogo, t->mapa, t->semente);
+    unsigned long long proximaAmostra = inicio + (unsigned long long)(t->intervaloAmostra * 1e9);
+    for (long n = 1; t->jogos > 0 ? n <= t->jogos : agora() < fim; n++) {
+        reiniciarJogo(&jogo, t->semente + (uint64_t)n);
+
+        for (int passo = 0; passo < LIMITE_PASSOS; passo++) {
+            unsigned long long t0 = agora();
+
+            char tecla;
+            if (t->backend != NULL) {
+                while (lerEntrada(&entrada, &tecla) == 1)
+                    mudarDirecao(&jogo, tecla);
+            } else if (sortearTecla(&estado) % 4 == 0) {
+                mudarDirecao(&jogo, TECLAS[sortearTecla(&estado) % sizeof(TECLAS)]);
+            }
+            desviar(&jogo, &estado);
+
+            if (!t->semTela) {
+                renderizarTela(&jogo, quadro);
+            }
+            int x = jogo.cobrinha.cabeca->x, y = jogo.cobrinha.cabeca->y;
+            char direcao = jogo.direcao;
+            ResultadoPasso resultado = passoJogo(&jogo);
+
+            registrarHistograma(&t->latencias, agora() - t0);
+            t->passos++;
+            if (resultado == PASSO_FIM)
+                break;
+            contarTravessia(t, &jogo, x, y, direcao);
+        }
+
+        t->pontos += jogo.pontos;
+        t->feitos = n;
+
+        if (t->indice == 0 && agora() >= proximaAmostra) {
+            amostrarMemoria(t, n);
+            proximaAmostra += (unsigned long long)(t->intervaloAmostra * 1e9);
+        }
+    }
+    finalizarJogo(&jogo);
+
+    if (t->backend != NULL) {
+        atomic_store(&digitador.parar, 1);
+        pthread_join(thread, NULL);
+        encerrarEntrada(&entrada);
+        close(fonte[0]);
+        close(fonte[1]);
+    }
+    free(quadro);
+    return NULL;
+}
+
+// Lê "chave valor" por linha; linhas começadas com # são comentários
+static int lerLinhaBase(const char* caminho, LinhaBase* base) {
+    FILE* arquivo = fopen(caminho, "r");
+    if (arquivo == NULL) {
+        perror(caminho);
+        return -1;
+    }
+    char linha[256], chave[64];
+    double valor;
+    int achados = 0;
+    while (fgets(linha, sizeof(linha), arquivo) != NULL) {
+        if (linha[0] == '#' || sscanf(linha, "%63s %lf", chave, &valor) != 2)
+            continue;
+        if (strcmp(chave, "passos_por_segundo") == 0) {
+            base->passosPorSegundo = valor;
+            achados++;
+        } else if (strcmp(chave, "p99_ns") == 0) {
+            base->p99 = valor;
+            achados++;
+        } else if (strcmp(chave, "p999_ns") == 0) {
+            base->p999 = valor;
+            achados++;
+        }
+    }
+    fclose(arquivo);
+    if (achados != 3) {
+        fprintf(stderr, "%s: linha de base incompleta.\n", caminho);
+        return -1;
+    }
+    return 0;
+}
+
+static int gravarLinhaBase(const char* caminho, const LinhaBase* base) {
+    FILE* arquivo = fopen(caminho, "w");
+    if (arquivo == NULL) {
+        perror(caminho);
+        return -1;
+    }
+    fprintf(arquivo, "# Linha de base do soak (cobrinha_soak -g); regrave ao trocar de máquina\n");
+    fprintf(arquivo, "passos_por_segundo %.0f\n", base->passosPorSegundo);
+    fprintf(arquivo, "p99_ns %.0f\n", base->p99);
+    fprintf(arquivo, "p999_ns %.0f\n", base->p999);
+    fclose(arquivo);
+    return 0;
+}
+
+static int compararLinhaBase(const LinhaBase* base, const LinhaBase* medida, double tolerancia) {
+    int regrediu = 0;
+    if (medida->passosPorSegundo < base->passosPorSegundo * (1.0 - tolerancia)) {
+        printf("REGRESSÃO: %.0f passos/s, linha de base %.0f\n", medida->passosPorSegundo, base->passosPorSegundo);
+        regrediu = 1;
+    }
+    if (medida->p99 > base->p99 * (1.0 + tolerancia)) {
+        printf("REGRESSÃO: p99 de %.0f ns, linha de base %.0f ns\n", medida->p99, base->p99);
+        regrediu = 1;
+    }
+    if (medida->p999 > base->p999 * (1.0 + tolerancia)) {
+        printf("REGRESSÃO: p99.9 de %.0f ns, linha de base %.0f ns\n", medida->p999, base->p999);
+        regrediu = 1;
+    }
+    return regrediu;
+}
+
+static void uso(const char* programa) {
+    fprintf(stderr, "Uso: %s [-d segundos | -j jogos] [-p threads] [-b backend] [-s semente] [-a segundos]\n", programa);
+    fprintf(stderr, "       [-m mapa] [-n] [-r linha_base] [-g linha_base] [-x tolerancia]\n");
+    fprintf(stderr, "  -d  duração do soak (padrão %.0f s); -j joga um número fixo de partidas\n", DURACAO_PADRAO);
+    fprintf(stderr, "  -a  intervalo entre amostras de memória (padrão %.0f s)\n", INTERVALO_AMOSTRA);
+    fprintf(stderr, "  -x  tolerância contra a linha de base (padrão %.2f)\n", TOLERANCIA_PADRAO);
+}
+
+int main(int argc, char* argv[]) {
+    long jogos = 0;
+    double duracao = DURACAO_PADRAO;
+    int threads = 1;
+    const char* backend = NULL;
+    uint64_t semente = 1;
+    double intervaloAmostra = INTERVALO_AMOSTRA;
+    const char* arquivoMapa = NULL;
+    int semTela = 0;
+    const char* linhaBase = NULL;
+    const char* gravar = NULL;
+    double tolerancia = TOLERANCIA_PADRAO;
+    int opcao;
+
+    while ((opcao = getopt(argc, argv, "d:j:p:b:s:a:m:nr:g:x:h")) != -1) {
+        switch (opcao) {
+            case 'd':
+                duracao = atof(optarg);
+                break;
+            case 'j':
+                jogos = atol(optarg);
+                break;
+            case 'p':
+                threads = atoi(optarg);
+                break;
+            case 'b':
+                backend = optarg;
+                break;
+            case 's':
+                semente = strtoull(optarg, NULL, 10);
+                break;
+            case 'a':
+                intervaloAmostra = atof(optarg);
+                break;
+            case 'm':
+                arquivoMapa = optarg;
+                break;
+            case 'n':
+                semTela = 1;
+                break;
+            case 'r':
+                linhaBase = optarg;
+                break;
+            case 'g':
+                gravar = optarg;
+                break;
+            case 'x':
+                tolerancia = atof(optarg);
+                break;
+            default:
+                uso(argv[0]);
+                return opcao == 'h' ? EXIT_SUCCESS : EXIT_FAILURE;
+        }
+    }
+    if (jogos < 0 || duracao <= 0 || threads <= 0 || intervaloAmostra <= 0) {
+        uso(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    Mapa mapa;
+    if ((arquivoMapa != NULL ? carregarMapa(&mapa, arquivoMapa) : mapaPadrao(&mapa)) == -1)
+        return EXIT_FAILURE;
+
+    // O digitador escreve num pipe cujo leitor pode ter sido encerrado antes dele
+    signal(SIGPIPE, SIG_IGN);
+
+    Trabalhador* trabalhadores = calloc(threads, sizeof(Trabalhador));
+    pthread_t* ids = calloc(threads, sizeof(pthread_t));
+    if (trabalhadores == NULL || ids == NULL) {
+        printf("Erro: Não foi possível alocar memória para os trabalhadores.\n");
+        return EXIT_FAILURE;
+    }
+
+    inicio = agora();
+    fim = inicio + (unsigned long long)(duracao * 1e9);
+    for (int i = 0; i < threads; i++) {
+        Trabalhador* t = &trabalhadores[i];
+        t->indice = i;
+        t->jogos = jogos > 0 ? jogos / threads + (i < jogos % threads ? 1 : 0) : 0;
+        t->semente = semente + (uint64_t)i * 0x100000000ULL;
+        t->backend = backend;
+        t->mapa = &mapa;
+        t->semTela = semTela;
+        t->intervaloAmostra = intervaloAmostra;
+        if (pthread_create(&ids[i], NULL, trabalhar, t) != 0) {
+            printf("Erro ao criar thread do soak.\n");
+            return EXIT_FAILURE;
+        }
+    }
+
+    Histograma total;
+    memset(&total, 0, sizeof(total));
+    long long passos = 0, pontos = 0, portais = 0, bordas = 0;
+    long feitos = 0;
+    int erros = 0;
+    for (int i = 0; i < threads; i++) {
+        pthread_join(ids[i], NULL);
+        feitos += trabalhadores[i].feitos;
+        portais += trabalhadores[i].portais;
+        bordas += trabalhadores[i].bordas;
+        juntarHistogramas(&total, &trabalhadores[i].latencias);
+        passos += trabalhadores[i].passos;
+        pontos += trabalhadores[i].pontos;
+        erros += trabalhadores[i].erro;
+    }
+    double segundos = (agora() - inicio) / 1e9;
+
+    LinhaBase medida = {
+        passos / segundos,
+        (double)percentilHistograma(&total, 0.99),
+        (double)percentilHistograma(&total, 0.999),
+    };
+    printf("\n%ld jogos, %lld passos, %lld pontos em %.2f s (%d threads, backend %s, mapa %dx%d%s)\n",
+           feitos, passos, pontos, segundos, threads, backend != NULL ? backend : "nenhum",
+           mapa.largura, mapa.altura, semTela ? ", sem tela" : "");
+    printf("%.0f jogos/s, %.0f passos/s, %.1f passos e %.2f pontos por jogo\n", feitos / segundos,
+           medida.passosPorSegundo, feitos > 0 ? (double)passos / feitos : 0.0,
+           feitos > 0 ? (double)pontos / feitos : 0.0);
+    printf("travessias: %lld por portal, %lld pela borda\n", portais, bordas);
+    printf("latência por passo: p50 %llu ns, p99 %.0f ns, p99.9 %.0f ns, max %llu ns\n",
+           percentilHistograma(&total, 0.50), medida.p99, medida.p999, total.maximo);
+
+    int falhou = erros != 0;
+
+    Trabalhador* primeiro = &trabalhadores[0];
+    long rssFinal = memoriaResidente();
+    if (rssFinal > primeiro->rssMaximo)
+        primeiro->rssMaximo = rssFinal;
+    printf("rss: inicial %ld KB, máximo %ld KB, final %ld KB\n", primeiro->rssInicial, primeiro->rssMaximo, rssFinal);
+    if (!SANITIZER_DE_ENDERECO && primeiro->rssInicial > 0 && primeiro->rssMaximo - primeiro->rssInicial > CRESCIMENTO_RSS) {
+        printf("REGRESSÃO: a memória cresceu %ld KB durante o soak\n", primeiro->rssMaximo - primeiro->rssInicial);
+        falhou = 1;
+    }
+
+    if (gravar != NULL && gravarLinhaBase(gravar, &medida) == -1)
+        falhou = 1;
+
+    if (linhaBase != NULL) {
+        LinhaBase base;
+        if (lerLinhaBase(linhaBase, &base) == -1 || compararLinhaBase(&base, &medida, tolerancia))
+            falhou = 1;
+        else
+            printf("Dentro da linha de base (tolerância de %.0f%%).\n", tolerancia * 100);
+    }
+
+    free(trabalhadores);
+    free(ids);
+    liberarMapa(&mapa);
+    return falhou ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,30 @@
+#ifndef SORTEIO_H
+#define SORTEIO_H
+
+#include <stdint.h>
+
+// Geradores pseudoaleatórios da biblioteca, dos testes e das ferramentas.
+// Cabeçalho interno; o estado nunca pode ser zero (os dois ficam presos no zero).
+
+// Um passo do xorshift64 (13, 7, 17); devolve o novo estado
+static inline uint64_t xorshift64(uint64_t* estado) {
+    uint64_t x = *estado;
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    *estado = x;
+    return x;
+}
+
+// Um passo do xorshift64* (12, 25, 27 e multiplicação), com 32 bits de saída de
+// melhor qualidade; é o gerador da comida, então a sequência não pode mudar
+static inline uint32_t xorshift64Estrela(uint64_t* estado) {
+    uint64_t x = *estado;
+    x ^= x >> 12;
+    x ^= x << 25;
+    x ^= x >> 27;
+    *estado = x;
+    return (uint32_t)((x * 0x2545F4914F6CDD1DULL) >> 32);
+}
+
+#endif
@@ -154,7 +154,7 @@ int main() {
             if(kbhit()) {
                 direcao = getchar();
                 buff[0] = direcao;
-                write(pipe1[1], buff, 10);
+                write(pipe1[1], buff, MAXBUFF);
             }
         }
 
@@ -166,6 +166,7 @@ int main() {
 	else // PROCESSO FILHO
 
 	   {	close(pipe1[1]); // fecha escrita no pipe1
+        fcntl(pipe1[0], F_SETFL, fcntl(pipe1[0], F_GETFL, 0) | O_NONBLOCK); // o jogo não espera por teclas
 
 
         while(jogarNovamente) {
@@ -175,8 +176,7 @@ int main() {
 
             while(1) {
 
-                read(pipe1[1], buff, 10);
-                if(buff[0]=='a' || buff[0]=='s' || buff[0]=='d' || buff[0]=='w')
+                if(read(pipe1[0], buff, MAXBUFF) == MAXBUFF && (buff[0]=='a' || buff[0]=='s' || buff[0]=='d' || buff[0]=='w'))
                     direcao = buff[0];
 
                 // Inicializa a tela
@@ -240,15 +240,21 @@ int main() {
                     break;
                 }
 
+                // O break só sairia do laço que percorre o corpo; a flag encerra a partida
+                int colidiu = 0;
                 atual = cobrinha.cabeca->prox;
                 while (atual != NULL) {
                     if (atual->x == cobrinha.cabeca->x && atual->y == cobrinha.cabeca->y) {
-                        printf("Game Over! Score: %d\n", pontos);
-                        freeLista(&cobrinha);
+                        colidiu = 1;
                         break;
                     }
                     atual = atual->prox;
                 }
+                if (colidiu) {
+                    printf("Game Over! Score: %d\n", pontos);
+                    freeLista(&cobrinha);
+                    break;
+                }
 
                 // Check se a cobrinha comeu a comida
                 if(cobrinha.cabeca->x == comidaX && cobrinha.cabeca->y == comidaY) {
@@ -262,6 +268,7 @@ int main() {
                     }
                     free(temp->prox);
                     temp->prox = NULL;
+                    cobrinha.cauda = temp;
                 }
             }
 
@@ -0,0 +1,111 @@
+// Teste da curva de dificuldade: especificações válidas têm de dar uma tabela que
+// nunca sobe, começa no intervalo inicial e fica entre o mínimo e o inicial; as
+// inválidas (inclusive com números negativos) têm de ser recusadas. Também confere
+// que atrasoPasso segura pontuações fora da tabela. Sai com falha se algo divergir.
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "jogo.h"
+
+typedef struct {
+    const char* especificacao;
+    unsigned inicial;
+    unsigned minimo;
+} CurvaValida;
+
+static const CurvaValida VALIDAS[] = {
+    {CURVA_PADRAO, 200000, 8000},
+    {"constante:50000", 50000, 50000},
+    {"linear:200000:8000:1000", 200000, 8000},
+    {"linear:1000:1000:0", 1000, 1000},
+    {"exp:100000:100000:1", 100000, 100000},
+    {"exp:3:1:0.5", 3, 1},
+};
+
+static const char* const INVALIDAS[] = {
+    "",
+    "exp",
+    "exp:200000",
+    "rapida:200000:8000:0.95",
+    "constante:0",
+    "constante:-5",
+    "linear:-5:1:1",
+    "linear:200000:-8000:1000",
+    "linear:200000:8000:-1",
+    "linear:200000:0:1000",
+    "exp:8000:200000:0.95",
+    "exp:200000:8000:0",
+    "exp:200000:8000:1.5",
+    "exp:-200000:8000:0.95",
+};
+
+static int falhas;
+
+static void falhar(const char* especificacao, const char* motivo) {
+    printf("'%s': %s\n", especificacao, motivo);
+    falhas++;
+}
+
+static void conferirValida(const CurvaValida* caso) {
+    Curva curva;
+    if (lerCurva(&curva, caso->especificacao) == -1) {
+        falhar(caso->especificacao, "curva válida foi recusada");
+        return;
+    }
+    if (curva.intervalos[0] != caso->inicial)
+        falhar(caso->especificacao, "a tabela não começa no intervalo inicial");
+    for (int nivel = 0; nivel < NIVEIS_CURVA; nivel++) {
+        unsigned intervalo = curva.intervalos[nivel];
+        if (intervalo < caso->minimo || intervalo > caso->inicial) {
+            falhar(caso->especificacao, "intervalo fora de [mínimo, inicial]");
+            return;
+        }
+        if (nivel > 0 && intervalo > curva.intervalos[nivel - 1]) {
+            falhar(caso->especificacao, "a tabela sobe com a pontuação");
+            return;
+        }
+    }
+}
+
+// atrasoPasso só lê a curva e os pontos; a partida não precisa de mapa
+static void conferirAtraso(void) {
+    Curva curva;
+    if (lerCurva(&curva, "linear:200000:8000:1000") == -1) {
+        falhar("atrasoPasso", "curva de teste recusada");
+        return;
+    }
+    Jogo jogo;
+    memset(&jogo, 0, sizeof(jogo));
+    if (atrasoPasso(&jogo) != DELAY_HORIZONTAL)
+        falhar("atrasoPasso", "sem curva não usou o ritmo constante");
+
+    jogo.curva = &curva;
+    const int pontos[] = {-1000000, -1, 0, 1, NIVEIS_CURVA - 1, NIVEIS_CURVA, 1000000};
+    for (size_t i = 0; i < sizeof(pontos) / sizeof(pontos[0]); i++) {
+        int nivel = pontos[i] < 0 ? 0 : pontos[i] < NIVEIS_CURVA ? pontos[i] : NIVEIS_CURVA - 1;
+        jogo.pontos = pontos[i];
+        if (atrasoPasso(&jogo) != curva.intervalos[nivel]) {
+            printf("atrasoPasso: %d pontos não deu o intervalo do nível %d\n", pontos[i], nivel);
+            falhas++;
+        }
+    }
+}
+
+int main(void) {
+    for (size_t i = 0; i < sizeof(VALIDAS) / sizeof(VALIDAS[0]); i++)
+        conferirValida(&VALIDAS[i]);
+
+    // As recusas escrevem o motivo em stderr; aqui só importa que devolvam -1
+    for (size_t i = 0; i < sizeof(INVALIDAS) / sizeof(INVALIDAS[0]); i++) {
+        Curva curva;
+        if (lerCurva(&curva, INVALIDAS[i]) != -1)
+            falhar(INVALIDAS[i], "curva inválida foi aceita");
+    }
+
+    conferirAtraso();
+    if (falhas == 0)
+        printf("curva: %zu válidas e %zu inválidas conferidas\n", sizeof(VALIDAS) / sizeof(VALIDAS[0]),
+               sizeof(INVALIDAS) / sizeof(INVALIDAS[0]));
+    return falhas == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
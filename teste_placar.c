@@ -0,0 +1,301 @@
+// Teste do placar num diretório temporário: depois de cada cenário de queda ou de
+// índice estragado, o placar reaberto tem de dar as mesmas respostas que uma
+// ordenação força bruta das partidas válidas do log. Cenários: gravação em lotes e
+// avulsa com compactação, reabertura pelo índice, cauda rasgada, índice velho,
+// truncado, de outro log, com cabeçalho trocado ou apagado, e registro corrompido
+// no meio do log. Sai com falha se algum cenário divergir.
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "placar.h"
+#include "sorteio.h"
+
+#define PARTIDAS_LOTE 6000 // Mais que as recentes que cabem fora do índice
+#define PARTIDAS_AVULSAS 50
+#define MELHORES 100
+#define CABECALHO_LOG 8
+#define TAMANHO_REGISTRO 32
+
+static char caminho[64];
+static char caminhoIndice[sizeof(caminho) + 4];
+
+// Partidas gravadas, na ordem do log, e quais delas ainda são válidas
+static Partida* gravadas;
+static int* validas;
+static size_t numGravadas;
+static int falhas;
+
+static void falhar(const char* cenario, const char* motivo) {
+    printf("%s: %s\n", cenario, motivo);
+    falhas++;
+}
+
+static Partida sortearPartida(uint64_t* estado) {
+    xorshift64(estado);
+    // Poucas pontuações diferentes: muitos empates para conferir o desempate pela ordem
+    Partida partida = {(int)(*estado % 300), (uint32_t)(*estado >> 20) % 1000, *estado >> 8, *estado,
+                       (uint32_t)(*estado >> 40)};
+    return partida;
+}
+
+static void guardar(const Partida* partidas, size_t n) {
+    gravadas = realloc(gravadas, (numGravadas + n) * sizeof(Partida));
+    validas = realloc(validas, (numGravadas + n) * sizeof(int));
+    if (gravadas == NULL || validas == NULL) {
+        printf("Erro: Não foi possível alocar memória para as partidas.\n");
+        exit(EXIT_FAILURE);
+    }
+    for (size_t i = 0; i < n; i++) {
+        gravadas[numGravadas] = partidas[i];
+        validas[numGravadas++] = 1;
+    }
+}
+
+static int gravar(Placar* placar, uint64_t* estado, size_t n, int avulsas) {
+    Partida* partidas = malloc(n * sizeof(Partida));
+    if (partidas == NULL)
+        return -1;
+    for (size_t i = 0; i < n; i++)
+        partidas[i] = sortearPartida(estado);
+    int resultado = 0;
+    if (avulsas) {
+        for (size_t i = 0; i < n && resultado == 0; i++)
+            resultado = registrarPartida(placar, &partidas[i]);
+    } else {
+        resultado = registrarPartidas(placar, partidas, n);
+    }
+    if (resultado == 0)
+        guardar(partidas, n);
+    free(partidas);
+    return resultado;
+}
+
+// Posições das partidas válidas na ordem do placar: mais pontos, depois a mais antiga
+static int compararPosicoes(const void* a, const void* b) {
+    const Partida* x = &gravadas[*(const size_t*)a];
+    const Partida* y = &gravadas[*(const size_t*)b];
+    if (x->pontos != y->pontos)
+        return y->pontos - x->pontos;
+    return (*(const size_t*)a > *(const size_t*)b) - (*(const size_t*)a < *(const size_t*)b);
+}
+
+static int mesmaPartida(const Partida* a, const Partida* b) {
+    return a->pontos == b->pontos && a->comprimento == b->comprimento && a->duracao == b->duracao &&
+           a->replay == b->replay && a->mapa == b->mapa;
+}
+
+// Compara top-K, percentis e pontuações por percentil com a ordenação força bruta
+static void conferir(const Placar* placar, const char* cenario) {
+    size_t* ordem = malloc((numGravadas + 1) * sizeof(size_t));
+    Partida* melhores = malloc(MELHORES * sizeof(Partida));
+    if (ordem == NULL || melhores == NULL) {
+        printf("Erro: Não foi possível alocar memória para a conferência.\n");
+        exit(EXIT_FAILURE);
+    }
+    size_t total = 0;
+    for (size_t i = 0; i < numGravadas; i++)
+        if (validas[i])
+            ordem[total++] = i;
+    qsort(ordem, total, sizeof(size_t), compararPosicoes);
+
+    if (totalPartidas(placar) != total)
+        falhar(cenario, "total de partidas diferente do log");
+
+    size_t k = total < MELHORES ? total : MELHORES;
+    if (melhoresPartidas(placar, MELHORES, melhores) != k)
+        falhar(cenario, "número de melhores partidas errado");
+    else
+        for (size_t i = 0; i < k; i++)
+            if (!mesmaPartida(&melhores[i], &gravadas[ordem[i]])) {
+                falhar(cenario, "melhores partidas fora de ordem ou trocadas");
+                break;
+            }
+
+    // Percentil: fração abaixo da pontuação; ordem está do maior para o menor
+    for (int pontos = -1; pontos <= 301; pontos += 7) {
+        size_t abaixo = 0;
+        for (size_t i = 0; i < total; i++)
+            abaixo += gravadas[ordem[i]].pontos < pontos;
+        double esperado = total > 0 ? (double)abaixo / (double)total : 0.0;
+        if (percentilPontos(placar, pontos) != esperado) {
+            falhar(cenario, "percentil de uma pontuação errado");
+            break;
+        }
+    }
+    for (int centesimo = 0; centesimo <= 100; centesimo++) {
+        double p = centesimo / 100.0;
+        int esperado = 0;
+        if (total > 0)
+            esperado = gravadas[ordem[total - 1 - (size_t)(p * (double)(total - 1) + 0.5)]].pontos;
+        if (pontosNoPercentil(placar, p) != esperado) {
+            falhar(cenario, "pontuação num percentil errada");
+            break;
+        }
+    }
+    free(melhores);
+    free(ordem);
+}
+
+static int reabrir(Placar* placar, const char* cenario) {
+    fecharPlacar(placar);
+    if (abrirPlacar(placar, caminho) == -1) {
+        falhar(cenario, "não reabriu");
+        return -1;
+    }
+    conferir(placar, cenario);
+    return 0;
+}
+
+static off_t tamanhoArquivo(const char* arquivo) {
+    struct stat info;
+    return stat(arquivo, &info) == 0 ? info.st_size : -1;
+}
+
+static int escreverEm(const char* arquivo, off_t posicao, const void* dados, size_t n, int flags) {
+    int fd = open(arquivo, O_WRONLY | flags, 0644);
+    if (fd == -1)
+        return -1;
+    ssize_t escritos = flags & O_APPEND ? write(fd, dados, n) : pwrite(fd, dados, n, posicao);
+    close(fd);
+    return escritos == (ssize_t)n ? 0 : -1;
+}
+
+// Cópia inteira de um arquivo na memória
+static unsigned char* lerArquivo(const char* arquivo, size_t* tamanho) {
+    off_t n = tamanhoArquivo(arquivo);
+    int fd = open(arquivo, O_RDONLY);
+    unsigned char* dados = n > 0 && fd != -1 ? malloc((size_t)n) : NULL;
+    if (dados != NULL && pread(fd, dados, (size_t)n, 0) != n) {
+        free(dados);
+        dados = NULL;
+    }
+    if (fd != -1)
+        close(fd);
+    *tamanho = (size_t)n;
+    return dados;
+}
+
+// Inverte os bits de um byte do arquivo, garantindo que ele mude
+static int estragarByte(const char* arquivo, off_t posicao) {
+    int fd = open(arquivo, O_RDWR);
+    unsigned char byte;
+    int resultado = -1;
+    if (fd != -1 && pread(fd, &byte, 1, posicao) == 1) {
+        byte = (unsigned char)~byte;
+        resultado = pwrite(fd, &byte, 1, posicao) == 1 ? 0 : -1;
+    }
+    if (fd != -1)
+        close(fd);
+    return resultado;
+}
+
+static int trocarArquivo(const char* arquivo, const unsigned char* dados, size_t n) {
+    return escreverEm(arquivo, 0, dados, n, O_CREAT | O_TRUNC);
+}
+
+int main(void) {
+    char diretorio[] = "/tmp/cobrinha_testeXXXXXX";
+    if (mkdtemp(diretorio) == NULL) {
+        perror("mkdtemp");
+        return EXIT_FAILURE;
+    }
+    snprintf(caminho, sizeof(caminho), "%s/placar", diretorio);
+    snprintf(caminhoIndice, sizeof(caminhoIndice), "%s.idx", caminho);
+
+    Placar placar;
+    uint64_t estado = 42;
+    if (abrirPlacar(&placar, caminho) == -1)
+        return EXIT_FAILURE;
+    conferir(&placar, "vazio");
+
+    // Lote acima do limite de recentes e avulsas depois, fora do índice
+    if (gravar(&placar, &estado, PARTIDAS_LOTE, 0) == -1 || gravar(&placar, &estado, PARTIDAS_AVULSAS, 1) == -1)
+        falhar("gravação", "registrarPartidas falhou");
+    conferir(&placar, "gravação");
+    if (compactarPlacar(&placar) == -1)
+        falhar("compactação", "compactarPlacar falhou");
+    conferir(&placar, "compactação");
+    if (gravar(&placar, &estado, PARTIDAS_AVULSAS, 1) == -1)
+        falhar("depois da compactação", "registrarPartida falhou");
+    conferir(&placar, "depois da compactação");
+    if (reabrir(&placar, "reabertura") == 0 && placar.numIndice == 0)
+        falhar("reabertura", "o índice não foi usado");
+
+    // Queda no meio de uma escrita: sobra meio registro e um registro com soma errada
+    unsigned char rasgado[TAMANHO_REGISTRO + 13];
+    memset(rasgado, 0x5A, sizeof(rasgado));
+    off_t esperado = CABECALHO_LOG + (off_t)numGravadas * TAMANHO_REGISTRO;
+    if (escreverEm(caminho, 0, rasgado, sizeof(rasgado), O_APPEND) == -1)
+        falhar("cauda rasgada", "não foi possível estragar o log");
+    if (reabrir(&placar, "cauda rasgada") == 0 && tamanhoArquivo(caminho) != esperado)
+        falhar("cauda rasgada", "o log não foi truncado no último registro íntegro");
+    if (gravar(&placar, &estado, 1, 1) == -1)
+        falhar("cauda rasgada", "não grava depois do reparo");
+    reabrir(&placar, "gravação depois do reparo");
+
+    // Índice velho: cobre só o começo do log, o resto volta como recentes
+    size_t tamanhoVelho;
+    unsigned char* velho = lerArquivo(caminhoIndice, &tamanhoVelho);
+    if (velho == NULL || gravar(&placar, &estado, PARTIDAS_AVULSAS, 0) == -1)
+        falhar("índice velho", "não foi possível preparar");
+    else if (trocarArquivo(caminhoIndice, velho, tamanhoVelho) == -1)
+        falhar("índice velho", "não foi possível trocar o índice");
+    reabrir(&placar, "índice velho");
+
+    // Índice truncado, com o cabeçalho trocado e apagado: reconstruído a partir do log
+    if (velho != NULL && trocarArquivo(caminhoIndice, velho, tamanhoVelho / 2) == -1)
+        falhar("índice truncado", "não foi possível truncar o índice");
+    reabrir(&placar, "índice truncado");
+    if (estragarByte(caminhoIndice, 9) == -1)
+        falhar("índice com cabeçalho trocado", "não foi possível estragar o índice");
+    reabrir(&placar, "índice com cabeçalho trocado");
+    unlink(caminhoIndice);
+    if (reabrir(&placar, "índice apagado") == 0 && tamanhoArquivo(caminhoIndice) <= 0)
+        falhar("índice apagado", "o índice não foi regravado");
+
+    // Índice íntegro, mas de outro log: o último registro coberto não bate
+    char outro[sizeof(caminho) + 8];
+    char outroIndice[sizeof(outro) + 4];
+    snprintf(outro, sizeof(outro), "%s/outro", diretorio);
+    snprintf(outroIndice, sizeof(outroIndice), "%s.idx", outro);
+    Placar outroPlacar;
+    Partida partidaOutra = {1000, 1, 1, 1, 1};
+    size_t tamanhoOutro = 0;
+    unsigned char* indiceOutro = NULL;
+    if (abrirPlacar(&outroPlacar, outro) == 0) {
+        for (int i = 0; i < PARTIDAS_AVULSAS; i++)
+            registrarPartida(&outroPlacar, &partidaOutra);
+        compactarPlacar(&outroPlacar);
+        fecharPlacar(&outroPlacar);
+        indiceOutro = lerArquivo(outroIndice, &tamanhoOutro);
+    }
+    if (indiceOutro == NULL || trocarArquivo(caminhoIndice, indiceOutro, tamanhoOutro) == -1)
+        falhar("índice de outro log", "não foi possível trocar o índice");
+    reabrir(&placar, "índice de outro log");
+
+    // Registro estragado no meio do log: ignorado e contado quando o índice é refeito
+    size_t estragado = numGravadas / 3;
+    if (estragarByte(caminho, CABECALHO_LOG + (off_t)estragado * TAMANHO_REGISTRO + 5) == -1)
+        falhar("registro corrompido", "não foi possível estragar o log");
+    validas[estragado] = 0;
+    unlink(caminhoIndice);
+    if (reabrir(&placar, "registro corrompido") == 0 && placar.corrompidos != 1)
+        falhar("registro corrompido", "o registro estragado não foi contado");
+
+    fecharPlacar(&placar);
+    printf("placar: %zu partidas gravadas, %d falhas\n", numGravadas, falhas);
+    free(velho);
+    free(indiceOutro);
+    free(gravadas);
+    free(validas);
+    unlink(caminho);
+    unlink(caminhoIndice);
+    unlink(outro);
+    unlink(outroIndice);
+    rmdir(diretorio);
+    return falhas == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,209 @@
+// Teste dos snapshots: joga partidas nos mapas dados e, a cada passo, salva e
+// restaura a partida pelos dois caminhos (partida nova e por cima de outra),
+// conferindo corpo, ocupação, pontos, semente, comida, direção e relógio. A
+// partida restaurada por cima segue jogando junto com a original. Também confere
+// que qualquer byte trocado no snapshot é recusado, assim como snapshots com a soma
+// certa mas pontos negativos ou comida na parede. Sai com falha na primeira diferença.
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "binario.h"
+#include "jogo.h"
+#include "snapshot.h"
+#include "sorteio.h"
+
+#define PARTIDAS_PADRAO 100
+#define LIMITE_PASSOS 5000
+#define CORROMPER_A_CADA 97 // Passos entre dois snapshots corrompidos de propósito
+
+static const char DIRECOES[] = {CIMA, BAIXO, ESQUERDA, DIREITA};
+
+// Vira de vez em quando e sempre que a frente estiver bloqueada, para uma direção
+// que não bate no passo seguinte; assim as partidas duram o bastante para a
+// cobrinha crescer e atravessar portais e bordas
+static void escolherDirecao(Jogo* jogo, uint64_t* estado) {
+    if (xorshift64(estado) % 8 != 0 && direcaoSegura(jogo, jogo->direcao))
+        return;
+    int inicio = (int)(xorshift64(estado) % sizeof(DIRECOES));
+    for (int k = 0; k < (int)sizeof(DIRECOES); k++) {
+        char direcao = DIRECOES[(inicio + k) % sizeof(DIRECOES)];
+        if (direcaoSegura(jogo, direcao)) {
+            mudarDirecao(jogo, direcao);
+            return;
+        }
+    }
+}
+
+static int mesmaPartida(const Jogo* a, const Jogo* b) {
+    if (a->pontos != b->pontos || a->semente != b->semente || a->comidaX != b->comidaX ||
+        a->comidaY != b->comidaY || a->direcao != b->direcao || a->decorrido != b->decorrido)
+        return 0;
+    const Node* x = a->cobrinha.cabeca;
+    const Node* y = b->cobrinha.cabeca;
+    const Node* anterior = NULL;
+    for (; x != NULL && y != NULL; x = x->prox, y = y->prox) {
+        if (x->x != y->x || x->y != y->y || y->ant != anterior)
+            return 0;
+        anterior = y;
+    }
+    return x == NULL && y == NULL && b->cobrinha.cauda == anterior &&
+           memcmp(a->ocupacao, b->ocupacao, palavrasBitmap(a->mapa) * sizeof(uint64_t)) == 0;
+}
+
+static int emPortal(const Jogo* jogo) {
+    const Mapa* mapa = jogo->mapa;
+    for (const Node* atual = jogo->cobrinha.cabeca; atual != NULL; atual = atual->prox)
+        if (tipoCelula(mapa, atual->y * mapa->largura + atual->x) == CELULA_PORTAL)
+            return 1;
+    return 0;
+}
+
+// Dois segmentos seguidos que não são vizinhos: o corpo passa por um portal ou
+// (no mapa com contorno e sem portais) atravessa a borda
+static int corpoComSalto(const Jogo* jogo) {
+    for (const Node* atual = jogo->cobrinha.cabeca; atual->prox != NULL; atual = atual->prox) {
+        int dx = abs(atual->x - atual->prox->x), dy = abs(atual->y - atual->prox->y);
+        if (dx > 1 || dy > 1)
+            return 1;
+    }
+    return 0;
+}
+
+// Refaz a soma de um snapshot alterado de propósito e confere que ele é recusado
+static int recusaForjado(const Mapa* mapa, unsigned char* buffer, size_t usados) {
+    escrever32(buffer + usados - 4, fnv1a(FNV1A_INICIAL, buffer, usados - 4));
+    Jogo novo;
+    if (restaurarJogo(&novo, mapa, buffer, usados) == 0) {
+        finalizarJogo(&novo);
+        return 0;
+    }
+    return 1;
+}
+
+// Snapshots bem formados e com a soma certa, mas com um estado que o jogo não aceita
+static int testarForjados(const Mapa* mapa, const char* caminho, unsigned char* buffer, size_t capacidade) {
+    Jogo jogo;
+    inicializarJogo(&jogo, mapa, 1);
+    size_t usados = salvarJogo(&jogo, buffer, capacidade);
+    finalizarJogo(&jogo);
+
+    escrever32(buffer + 16, 0x80000000u);
+    if (!recusaForjado(mapa, buffer, usados)) {
+        printf("%s: snapshot com pontos negativos foi aceito\n", caminho);
+        return -1;
+    }
+    escrever32(buffer + 16, 0);
+
+    for (int i = 0; i < mapa->largura * mapa->altura; i++) {
+        if (tipoCelula(mapa, i) != CELULA_PAREDE)
+            continue;
+        escrever16(buffer + 6, (uint16_t)(i % mapa->largura));
+        escrever16(buffer + 8, (uint16_t)(i / mapa->largura));
+        if (!recusaForjado(mapa, buffer, usados)) {
+            printf("%s: snapshot com comida na parede foi aceito\n", caminho);
+            return -1;
+        }
+        break;
+    }
+    return 0;
+}
+
+static int testarMapa(const char* caminho, int partidas) {
+    Mapa mapa;
+    if (carregarMapa(&mapa, caminho) == -1)
+        return -1;
+
+    // Maior snapshot possível: a cobrinha ocupando o mapa inteiro
+    size_t capacidade = CABECALHO_SNAPSHOT + ((size_t)mapa.largura * mapa.altura + 2) / 4 + 4;
+    unsigned char* buffer = malloc(capacidade);
+    if (buffer == NULL) {
+        printf("Erro: Não foi possível alocar memória para o snapshot.\n");
+        exit(EXIT_FAILURE);
+    }
+
+    Jogo jogo, novo, sobre;
+    inicializarJogo(&sobre, &mapa, 1);
+    uint64_t estado = 0x9E3779B97F4A7C15ULL;
+    long snapshots = 0, comPortal = 0, comSalto = 0, corrompidos = 0;
+    int falhou = testarForjados(&mapa, caminho, buffer, capacidade) == -1;
+
+    for (int partida = 0; partida < partidas && !falhou; partida++) {
+        inicializarJogo(&jogo, &mapa, (uint64_t)partida + 1);
+        for (int passo = 0; passo < LIMITE_PASSOS && !falhou; passo++) {
+            size_t usados = salvarJogo(&jogo, buffer, capacidade);
+            if (usados != tamanhoSnapshot(&jogo)) {
+                printf("%s: partida %d passo %d: salvarJogo devolveu %zu bytes\n", caminho, partida, passo, usados);
+                falhou = 1;
+                break;
+            }
+            if (restaurarJogo(&novo, &mapa, buffer, usados) == -1 || !mesmaPartida(&jogo, &novo)) {
+                printf("%s: partida %d passo %d: restaurarJogo não reproduziu a partida\n", caminho, partida, passo);
+                falhou = 1;
+                break;
+            }
+            finalizarJogo(&novo);
+            if (restaurarSobreJogo(&sobre, buffer, usados) == -1 || !mesmaPartida(&jogo, &sobre)) {
+                printf("%s: partida %d passo %d: restaurarSobreJogo não reproduziu a partida\n", caminho, partida, passo);
+                falhou = 1;
+                break;
+            }
+            snapshots++;
+            comPortal += emPortal(&jogo);
+            comSalto += corpoComSalto(&jogo);
+
+            if (passo % CORROMPER_A_CADA == 0) {
+                size_t i = (size_t)(xorshift64(&estado) % usados);
+                unsigned char bit = (unsigned char)(1u << (xorshift64(&estado) % 8));
+                buffer[i] ^= bit;
+                if (restaurarJogo(&novo, &mapa, buffer, usados) == 0) {
+                    printf("%s: partida %d passo %d: snapshot com o byte %zu trocado foi aceito\n",
+                           caminho, partida, passo, i);
+                    finalizarJogo(&novo);
+                    falhou = 1;
+                    break;
+                }
+                corrompidos++;
+            }
+
+            // A cópia restaurada continua a partida: mesma tecla, mesmo resultado
+            escolherDirecao(&jogo, &estado);
+            mudarDirecao(&sobre, jogo.direcao);
+            ResultadoPasso resultado = passoJogo(&jogo);
+            if (passoJogo(&sobre) != resultado || (resultado != PASSO_FIM && !mesmaPartida(&jogo, &sobre))) {
+                printf("%s: partida %d passo %d: a partida restaurada seguiu outro caminho\n", caminho, partida, passo);
+                falhou = 1;
+            }
+            if (resultado == PASSO_FIM)
+                break;
+        }
+        finalizarJogo(&jogo);
+    }
+
+    finalizarJogo(&sobre);
+    free(buffer);
+    printf("%s: %ld snapshots, %ld com corpo em portal, %ld com salto no corpo, %ld corrompidos recusados\n",
+           caminho, snapshots, comPortal, comSalto, corrompidos);
+    if (!falhou && mapa.numPortais > 0 && comPortal == 0) {
+        printf("%s: nenhuma partida passou por um portal\n", caminho);
+        falhou = 1;
+    }
+    if (!falhou && mapa.contorno && comSalto == 0) {
+        printf("%s: nenhuma partida atravessou a borda\n", caminho);
+        falhou = 1;
+    }
+    liberarMapa(&mapa);
+    return falhou ? -1 : 0;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        fprintf(stderr, "Uso: %s mapa...\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+    int falhas = 0;
+    for (int i = 1; i < argc; i++)
+        if (testarMapa(argv[i], PARTIDAS_PADRAO) == -1)
+            falhas++;
+    return falhas == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}